@@ -42,6 +42,8 @@ struct destruction
 #include "rxmousedrags.h"
 #include "rxhttp.h"
 #include "rxtime.h"
+#include "rxzip.h"
+#include "rxparallel.h"
 #include "designpush.h"
 #include "designcontract.h"
 //#include "designtime.h"
@@ -0,0 +1,571 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_OPERATORS_RX_GROUP_BY_HASHED_HPP)
+#define RXCPP_OPERATORS_RX_GROUP_BY_HASHED_HPP
+
+#include "../rx-includes.hpp"
+#include "rx-group_by.hpp"
+#include "rx-observe_on.hpp"
+
+namespace rxcpp {
+
+namespace operators {
+
+// bounds the groups that group_by_hashed keeps.
+// an evicted group is completed. a later value with the same key starts a new group.
+struct group_eviction
+{
+    typedef rxsc::scheduler::clock_type::duration duration_type;
+
+    group_eviction()
+        : max_groups(0)
+        , idle(duration_type::zero())
+    {
+    }
+    group_eviction(std::size_t mg, duration_type i = duration_type::zero())
+        : max_groups(mg)
+        , idle(i)
+    {
+    }
+
+    // the least recently used group is evicted to make room for a new group. 0 is unbounded
+    std::size_t max_groups;
+    // a group that has not had a value for this long is evicted. zero never evicts
+    duration_type idle;
+
+    bool empty() const {
+        return max_groups == 0 && idle == duration_type::zero();
+    }
+};
+
+namespace detail {
+
+struct group_by_hash
+{
+    template<class Key>
+    std::size_t operator()(const Key& k) const {
+        return rxcpp::filtered_hash<rxu::decay_t<Key>>()(k);
+    }
+};
+
+// an open addressing (linear probing) map from key to group.
+// the slots hold the cached hash and the index of the node that has the key and group.
+// nodes do not move, so the least recently used order is kept as links between node indexes.
+template<class Key, class Group, class KeyEqual>
+class group_by_hashed_table
+{
+public:
+    typedef rxsc::scheduler::clock_type::time_point time_point;
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+private:
+    struct slot
+    {
+        std::size_t hash;
+        std::size_t node;
+    };
+    struct node
+    {
+        node() : hash(0), prev(npos), next(npos) {}
+        rxu::maybe<std::pair<Key, Group>> entry;
+        std::size_t hash;
+        std::size_t prev;
+        std::size_t next;
+        time_point last;
+    };
+
+    KeyEqual equal;
+    std::vector<slot> slots;
+    std::vector<node> nodes;
+    std::vector<std::size_t> unused;
+    std::size_t count;
+    std::size_t shift;
+    // most and least recently used
+    std::size_t head;
+    std::size_t tail;
+
+    // fibonacci hashing takes the high bits, so keys that were sharded by the low bits still spread
+    std::size_t home(std::size_t hash) const {
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+    std::size_t mask() const {
+        return slots.size() - 1;
+    }
+    void grow() {
+        std::size_t bits = 64 - shift + 1;
+        if (slots.empty()) {
+            bits = 4;
+        }
+        std::vector<slot> old(std::size_t(1) << bits, slot{0, npos});
+        swap(old, slots);
+        shift = 64 - bits;
+        for (auto& s : old) {
+            if (s.node != npos) {
+                auto i = home(s.hash);
+                while (slots[i].node != npos) {
+                    i = (i + 1) & mask();
+                }
+                slots[i] = s;
+            }
+        }
+    }
+    void unlink(std::size_t n) {
+        auto& nd = nodes[n];
+        (nd.prev == npos ? head : nodes[nd.prev].next) = nd.next;
+        (nd.next == npos ? tail : nodes[nd.next].prev) = nd.prev;
+        nd.prev = nd.next = npos;
+    }
+    void link(std::size_t n) {
+        auto& nd = nodes[n];
+        nd.prev = npos;
+        nd.next = head;
+        (head == npos ? tail : nodes[head].prev) = n;
+        head = n;
+    }
+
+public:
+    explicit group_by_hashed_table(KeyEqual eq = KeyEqual())
+        : equal(std::move(eq))
+        , count(0)
+        , shift(64)
+        , head(npos)
+        , tail(npos)
+    {
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+    std::size_t least_recent() const {
+        return tail;
+    }
+    time_point last(std::size_t n) const {
+        return nodes[n].last;
+    }
+    Group& group(std::size_t n) {
+        return nodes[n].entry->second;
+    }
+
+    std::size_t find(const Key& k, std::size_t hash) {
+        if (count == 0) {
+            return npos;
+        }
+        for (auto i = home(hash); slots[i].node != npos; i = (i + 1) & mask()) {
+            if (slots[i].hash == hash && equal(nodes[slots[i].node].entry->first, k)) {
+                return slots[i].node;
+            }
+        }
+        return npos;
+    }
+
+    std::size_t insert(Key k, std::size_t hash, Group g, time_point now) {
+        if ((count + 1) * 2 > slots.size()) {
+            grow();
+        }
+        std::size_t n;
+        if (unused.empty()) {
+            n = nodes.size();
+            nodes.emplace_back();
+        } else {
+            n = unused.back();
+            unused.pop_back();
+        }
+        auto& nd = nodes[n];
+        nd.entry.reset(std::make_pair(std::move(k), std::move(g)));
+        nd.hash = hash;
+        nd.last = now;
+        link(n);
+        auto i = home(hash);
+        while (slots[i].node != npos) {
+            i = (i + 1) & mask();
+        }
+        slots[i] = slot{hash, n};
+        ++count;
+        return n;
+    }
+
+    // moves the node to the most recently used end
+    void touch(std::size_t n, time_point now) {
+        nodes[n].last = now;
+        if (head != n) {
+            unlink(n);
+            link(n);
+        }
+    }
+
+    Group erase(std::size_t n) {
+        auto& nd = nodes[n];
+        auto i = home(nd.hash);
+        while (slots[i].node != n) {
+            i = (i + 1) & mask();
+        }
+        // shift back the slots that probed past i so that no lookup stops early
+        for (auto j = (i + 1) & mask(); slots[j].node != npos; j = (j + 1) & mask()) {
+            auto h = home(slots[j].hash);
+            if ((j > i && (h <= i || h > j)) || (j < i && (h <= i && h > j))) {
+                slots[i] = slots[j];
+                i = j;
+            }
+        }
+        slots[i].node = npos;
+        unlink(n);
+        Group g = std::move(nd.entry->second);
+        nd.entry.reset();
+        unused.push_back(n);
+        --count;
+        return g;
+    }
+
+    template<class F>
+    void for_each(F f) {
+        for (auto& nd : nodes) {
+            if (!nd.entry.empty()) {
+                f(nd.entry->second);
+            }
+        }
+    }
+};
+
+template<class T, class Observable, class KeySelector, class MarbleSelector, class Coordination>
+struct group_by_hashed
+{
+    typedef group_by_traits<T, Observable, KeySelector, MarbleSelector, rxu::equal_to<>> traits_type;
+    typedef typename traits_type::key_selector_type key_selector_type;
+    typedef typename traits_type::marble_selector_type marble_selector_type;
+    typedef typename traits_type::marble_type marble_type;
+    typedef typename traits_type::subject_type subject_type;
+    typedef typename traits_type::key_type key_type;
+    typedef rxu::decay_t<Coordination> coordination_type;
+
+    typedef typename subject_type::subscriber_type group_type;
+    typedef group_by_hashed_table<key_type, group_type, rxu::equal_to<>> table_type;
+
+    // the key, the hash of the key and the marble, selected on the source thread
+    typedef std::tuple<key_type, std::size_t, marble_type> shard_value_type;
+
+    // identity coordinations process the groups on the source thread without a queue
+    typedef std::is_same<coordination_type, identity_one_worker> sequential_type;
+
+    struct group_by_hashed_state
+    {
+        group_by_hashed_state(composite_subscription sl, std::size_t shards)
+            : source_lifetime(sl)
+            , observers(0)
+            , remaining(shards)
+        {
+        }
+        composite_subscription source_lifetime;
+        // the lifetime of the shard workers, a completed source does not stop them
+        composite_subscription shard_lifetime;
+        std::atomic<int> observers;
+        // the shards that have not finished
+        std::atomic<std::size_t> remaining;
+        // held to emit a new group or the terminal to dest
+        std::mutex lock;
+    };
+
+    template<class Subscriber>
+    static void stopsource(Subscriber&& dest, std::shared_ptr<group_by_hashed_state>& state) {
+        ++state->observers;
+        dest.add([state](){
+            if (!state->source_lifetime.is_subscribed()) {
+                return;
+            }
+            --state->observers;
+            if (state->observers == 0) {
+                state->source_lifetime.unsubscribe();
+                state->shard_lifetime.unsubscribe();
+            }
+        });
+    }
+
+    struct group_by_hashed_values
+    {
+        group_by_hashed_values(key_selector_type ks, marble_selector_type ms, group_eviction ev, coordination_type cn, std::size_t s)
+            : keySelector(std::move(ks))
+            , marbleSelector(std::move(ms))
+            , eviction(ev)
+            , coordination(std::move(cn))
+            , shards(std::max<std::size_t>(s, 1))
+        {
+        }
+        mutable key_selector_type keySelector;
+        mutable marble_selector_type marbleSelector;
+        group_eviction eviction;
+        coordination_type coordination;
+        std::size_t shards;
+    };
+
+    group_by_hashed_values initial;
+
+    group_by_hashed(key_selector_type ks, marble_selector_type ms, group_eviction ev, coordination_type cn, std::size_t shards)
+        : initial(std::move(ks), std::move(ms), ev, std::move(cn), shards)
+    {
+    }
+
+    struct group_by_hashed_observable : public rxs::source_base<marble_type>
+    {
+        mutable std::shared_ptr<group_by_hashed_state> state;
+        subject_type subject;
+        key_type key;
+
+        group_by_hashed_observable(std::shared_ptr<group_by_hashed_state> st, subject_type s, key_type k)
+            : state(std::move(st))
+            , subject(std::move(s))
+            , key(k)
+        {
+        }
+
+        template<class Subscriber>
+        void on_subscribe(Subscriber&& o) const {
+            group_by_hashed::stopsource(o, state);
+            subject.get_observable().subscribe(std::forward<Subscriber>(o));
+        }
+
+        key_type on_get_key() {
+            return key;
+        }
+    };
+
+    template<class Subscriber>
+    struct group_by_hashed_observer : public group_by_hashed_values
+    {
+        typedef group_by_hashed_observer<Subscriber> this_type;
+        typedef typename traits_type::grouped_observable_type value_type;
+        typedef rxu::decay_t<Subscriber> dest_type;
+        typedef observer<T, this_type> observer_type;
+
+        // the groups of the keys that hash to one shard. only called from one thread at a time
+        struct shard_type
+        {
+            typedef typename table_type::time_point time_point;
+
+            shard_type(dest_type d, std::shared_ptr<group_by_hashed_state> st, group_by_hashed_values v)
+                : dest(std::move(d))
+                , state(std::move(st))
+                , eviction(v.eviction)
+                , coordination(std::move(v.coordination))
+            {
+                // the bound is split evenly over the shards
+                eviction.max_groups = (eviction.max_groups + v.shards - 1) / v.shards;
+            }
+
+            dest_type dest;
+            std::shared_ptr<group_by_hashed_state> state;
+            group_eviction eviction;
+            coordination_type coordination;
+            table_type groups;
+
+            void evict(std::size_t n) {
+                groups.erase(n).on_completed();
+            }
+
+            void on_next(shard_value_type v) {
+                auto& key = std::get<0>(v);
+                auto hash = std::get<1>(v);
+                time_point now;
+                if (!eviction.empty()) {
+                    now = coordination.now();
+                }
+                if (eviction.idle != group_eviction::duration_type::zero()) {
+                    // cold groups are found when the next value reaches the shard
+                    for (auto n = groups.least_recent(); n != table_type::npos && now - groups.last(n) >= eviction.idle; n = groups.least_recent()) {
+                        evict(n);
+                    }
+                }
+                auto g = groups.find(key, hash);
+                if (g == table_type::npos) {
+                    if (!dest.is_subscribed()) {
+                        return;
+                    }
+                    if (eviction.max_groups != 0 && groups.size() >= eviction.max_groups) {
+                        evict(groups.least_recent());
+                    }
+                    auto sub = subject_type();
+                    g = groups.insert(key, hash, sub.get_subscriber(), now);
+                    auto go = make_dynamic_grouped_observable<key_type, marble_type>(group_by_hashed_observable(state, sub, key));
+                    std::unique_lock<std::mutex> guard(state->lock);
+                    dest.on_next(std::move(go));
+                } else if (!eviction.empty()) {
+                    groups.touch(g, now);
+                }
+                groups.group(g).on_next(std::move(std::get<2>(v)));
+            }
+            void on_error(std::exception_ptr e) {
+                groups.for_each([&](group_type& g){
+                    g.on_error(e);
+                });
+                if (--state->remaining == 0) {
+                    std::unique_lock<std::mutex> guard(state->lock);
+                    dest.on_error(e);
+                }
+            }
+            void on_completed() {
+                groups.for_each([](group_type& g){
+                    g.on_completed();
+                });
+                if (--state->remaining == 0) {
+                    std::unique_lock<std::mutex> guard(state->lock);
+                    dest.on_completed();
+                }
+            }
+        };
+
+        struct shard_observer
+        {
+            std::shared_ptr<shard_type> shard;
+            void on_next(shard_value_type v) const {
+                shard->on_next(std::move(v));
+            }
+            void on_error(std::exception_ptr e) const {
+                shard->on_error(e);
+            }
+            void on_completed() const {
+                shard->on_completed();
+            }
+        };
+
+        typedef typename std::conditional<sequential_type::value,
+            std::shared_ptr<shard_type>,
+            subscriber<shard_value_type>>::type shard_input_type;
+
+        static shard_input_type make_input(std::shared_ptr<shard_type> s, const coordination_type&, composite_subscription, std::true_type) {
+            return s;
+        }
+        static shard_input_type make_input(std::shared_ptr<shard_type> s, const coordination_type& cn, composite_subscription cs, std::false_type) {
+            composite_subscription lifetime;
+            cs.add(lifetime);
+            return observe_on<shard_value_type, coordination_type>(cn)(
+                make_subscriber<shard_value_type>(lifetime, make_observer<shard_value_type>(shard_observer{std::move(s)}))).as_dynamic();
+        }
+
+        static void next(const std::shared_ptr<shard_type>& s, shard_value_type v) {
+            s->on_next(std::move(v));
+        }
+        static void next(const subscriber<shard_value_type>& s, shard_value_type v) {
+            s.on_next(std::move(v));
+        }
+        static void error(const std::shared_ptr<shard_type>& s, std::exception_ptr e) {
+            s->on_error(e);
+        }
+        static void error(const subscriber<shard_value_type>& s, std::exception_ptr e) {
+            s.on_error(e);
+        }
+        static void completed(const std::shared_ptr<shard_type>& s) {
+            s->on_completed();
+        }
+        static void completed(const subscriber<shard_value_type>& s) {
+            s.on_completed();
+        }
+
+        mutable std::shared_ptr<group_by_hashed_state> state;
+        std::vector<shard_input_type> inputs;
+
+        group_by_hashed_observer(composite_subscription l, dest_type d, group_by_hashed_values v)
+            : group_by_hashed_values(v)
+            , state(std::make_shared<group_by_hashed_state>(l, v.shards))
+        {
+            group_by_hashed::stopsource(d, state);
+            inputs.reserve(v.shards);
+            for (std::size_t i = 0; i != v.shards; ++i) {
+                auto shard = std::make_shared<shard_type>(d, state, v);
+                inputs.push_back(make_input(std::move(shard), v.coordination, state->shard_lifetime, sequential_type()));
+            }
+        }
+        void on_next(T v) const {
+            auto selectedKey = on_exception(
+                [&](){
+                    return this->keySelector(v);},
+                [this](std::exception_ptr e){on_error(e);});
+            if (selectedKey.empty()) {
+                return;
+            }
+            auto selectedMarble = on_exception(
+                [&](){
+                    return this->marbleSelector(v);},
+                [this](std::exception_ptr e){on_error(e);});
+            if (selectedMarble.empty()) {
+                return;
+            }
+            auto hash = group_by_hash()(selectedKey.get());
+            next(inputs[hash % inputs.size()], shard_value_type(std::move(selectedKey.get()), hash, std::move(selectedMarble.get())));
+        }
+        void on_error(std::exception_ptr e) const {
+            for (auto& i : inputs) {
+                error(i, e);
+            }
+        }
+        void on_completed() const {
+            for (auto& i : inputs) {
+                completed(i);
+            }
+        }
+
+        static subscriber<T, observer_type> make(dest_type d, group_by_hashed_values v) {
+            auto cs = composite_subscription();
+            return make_subscriber<T>(cs, observer_type(this_type(cs, std::move(d), std::move(v))));
+        }
+    };
+
+    template<class Subscriber>
+    auto operator()(Subscriber dest) const
+        -> decltype(group_by_hashed_observer<Subscriber>::make(std::move(dest), initial)) {
+        return      group_by_hashed_observer<Subscriber>::make(std::move(dest), initial);
+    }
+};
+
+template<class KeySelector, class MarbleSelector, class Coordination>
+class group_by_hashed_factory
+{
+    typedef rxu::decay_t<KeySelector> key_selector_type;
+    typedef rxu::decay_t<MarbleSelector> marble_selector_type;
+    typedef rxu::decay_t<Coordination> coordination_type;
+    key_selector_type keySelector;
+    marble_selector_type marbleSelector;
+    group_eviction eviction;
+    coordination_type coordination;
+    std::size_t shards;
+public:
+    group_by_hashed_factory(key_selector_type ks, marble_selector_type ms, group_eviction ev, coordination_type cn, std::size_t s)
+        : keySelector(std::move(ks))
+        , marbleSelector(std::move(ms))
+        , eviction(ev)
+        , coordination(std::move(cn))
+        , shards(s)
+    {
+    }
+    template<class Observable>
+    struct group_by_hashed_factory_traits
+    {
+        typedef rxu::value_type_t<rxu::decay_t<Observable>> value_type;
+        typedef detail::group_by_hashed<value_type, Observable, KeySelector, MarbleSelector, Coordination> group_by_hashed_type;
+        typedef typename group_by_hashed_type::traits_type traits_type;
+    };
+    template<class Observable>
+    auto operator()(Observable&& source)
+        -> decltype(source.template lift<typename group_by_hashed_factory_traits<Observable>::traits_type::grouped_observable_type>(typename group_by_hashed_factory_traits<Observable>::group_by_hashed_type(std::move(keySelector), std::move(marbleSelector), eviction, std::move(coordination), shards))) {
+        return      source.template lift<typename group_by_hashed_factory_traits<Observable>::traits_type::grouped_observable_type>(typename group_by_hashed_factory_traits<Observable>::group_by_hashed_type(std::move(keySelector), std::move(marbleSelector), eviction, std::move(coordination), shards));
+    }
+};
+
+}
+
+template<class KeySelector, class MarbleSelector, class Coordination>
+inline auto group_by_hashed(KeySelector ks, MarbleSelector ms, group_eviction ev, Coordination cn, std::size_t shards)
+    ->      detail::group_by_hashed_factory<KeySelector, MarbleSelector, Coordination> {
+    return  detail::group_by_hashed_factory<KeySelector, MarbleSelector, Coordination>(std::move(ks), std::move(ms), ev, std::move(cn), shards);
+}
+
+template<class KeySelector, class MarbleSelector>
+inline auto group_by_hashed(KeySelector ks, MarbleSelector ms, group_eviction ev = group_eviction())
+    ->      detail::group_by_hashed_factory<KeySelector, MarbleSelector, identity_one_worker> {
+    return  detail::group_by_hashed_factory<KeySelector, MarbleSelector, identity_one_worker>(std::move(ks), std::move(ms), ev, identity_current_thread(), 1);
+}
+
+}
+
+}
+
+#endif
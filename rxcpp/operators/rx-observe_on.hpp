@@ -13,6 +13,175 @@ namespace operators {
 
 namespace detail {
 
+// a queue of notifications from one producer to one consumer.
+// the source calls on_next, on_error and on_completed one at a time, so there is
+// one producer, and the drain that holds processing is the one consumer.
+// notifications are written in place into segments of pre-sized slots and no lock
+// is taken. the first segment is allocated by the first push. the consumer hands
+// a drained segment back to the producer, so a queue that stays short does not
+// allocate.
+template<class T>
+class observe_on_queue
+{
+    struct kind
+    {
+        enum type {
+            OnNext,
+            OnError,
+            OnCompleted
+        };
+    };
+    struct slot
+    {
+        typename kind::type what;
+        rxu::maybe<T> value;
+        std::exception_ptr error;
+    };
+
+    static const std::size_t segment_size = 256;
+
+    struct segment
+    {
+        segment() : next(nullptr) {}
+        slot slots[segment_size];
+        std::atomic<segment*> next;
+    };
+
+    // written by the producer
+    segment* tail;
+    // written by the producer before the first notification is published
+    segment* first;
+    std::atomic<std::size_t> pushed;
+    char pad[64];
+    // written by the consumer
+    segment* head;
+    std::atomic<std::size_t> popped;
+    // a drained segment for the producer to reuse
+    std::atomic<segment*> spare;
+
+    segment* make_segment() {
+        auto s = spare.exchange(nullptr, std::memory_order_acquire);
+        if (!s) {
+            s = new segment();
+        }
+        return s;
+    }
+    void recycle(segment* s) {
+        s->next.store(nullptr, std::memory_order_relaxed);
+        delete spare.exchange(s, std::memory_order_release);
+    }
+
+    slot& claim() {
+        auto p = pushed.load(std::memory_order_relaxed);
+        if (!tail) {
+            tail = first = make_segment();
+        } else if (p % segment_size == 0) {
+            auto next = make_segment();
+            tail->next.store(next, std::memory_order_relaxed);
+            tail = next;
+        }
+        return tail->slots[p % segment_size];
+    }
+    void publish() {
+        pushed.store(pushed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+public:
+    observe_on_queue()
+        : tail(nullptr)
+        , first(nullptr)
+        , pushed(0)
+        , head(nullptr)
+        , popped(0)
+        , spare(nullptr)
+    {
+    }
+    observe_on_queue(const observe_on_queue&) = delete;
+    observe_on_queue& operator=(const observe_on_queue&) = delete;
+    ~observe_on_queue()
+    {
+        clear();
+        while (head) {
+            auto next = head->next.load(std::memory_order_relaxed);
+            delete head;
+            head = next;
+        }
+        delete spare.load(std::memory_order_relaxed);
+    }
+
+    void push_next(T v) {
+        auto& s = claim();
+        s.what = kind::OnNext;
+        s.value.reset(std::move(v));
+        publish();
+    }
+    void push_error(std::exception_ptr e) {
+        auto& s = claim();
+        s.what = kind::OnError;
+        s.error = e;
+        publish();
+    }
+    void push_completed() {
+        auto& s = claim();
+        s.what = kind::OnCompleted;
+        publish();
+    }
+
+    // consumer only
+    bool empty() const {
+        return pushed.load(std::memory_order_acquire) == popped.load(std::memory_order_relaxed);
+    }
+
+    // consumer only. delivers the oldest notification to o.
+    // \returns false when the queue is empty
+    template<class Observer>
+    bool pop(const Observer& o) {
+        auto q = popped.load(std::memory_order_relaxed);
+        if (pushed.load(std::memory_order_acquire) == q) {
+            return false;
+        }
+        if (!head) {
+            head = first;
+        } else if (q % segment_size == 0) {
+            auto next = head->next.load(std::memory_order_relaxed);
+            recycle(head);
+            head = next;
+        }
+        auto& s = head->slots[q % segment_size];
+        popped.store(q + 1, std::memory_order_relaxed);
+        switch (s.what) {
+        case kind::OnNext:
+            {
+                RXCPP_UNWIND_AUTO([&](){s.value.reset();});
+                o.on_next(std::move(*s.value.begin()));
+            }
+            break;
+        case kind::OnError:
+            {
+                auto e = std::move(s.error);
+                s.error = nullptr;
+                o.on_error(e);
+            }
+            break;
+        case kind::OnCompleted:
+            o.on_completed();
+            break;
+        }
+        return true;
+    }
+
+    // consumer only. drops the notifications that have not been delivered
+    void clear() {
+        struct ignore
+        {
+            void on_next(T&&) const {}
+            void on_error(std::exception_ptr) const {}
+            void on_completed() const {}
+        };
+        while (pop(ignore())) {}
+    }
+};
+
 template<class T, class Coordination>
 struct observe_on
 {
@@ -36,9 +205,10 @@ struct observe_on
         typedef rxu::decay_t<Subscriber> dest_type;
         typedef observer<value_type, this_type> observer_type;
 
-        typedef rxn::notification<T> notification_type;
-        typedef typename notification_type::type base_notification_type;
-        typedef std::deque<base_notification_type> queue_type;
+        typedef observe_on_queue<source_value_type> queue_type;
+
+        // the most notifications delivered before the drain lets other actions on the worker run
+        static const std::size_t batch_size = 1024;
 
         struct mode
         {
@@ -52,99 +222,98 @@ struct observe_on
         };
         struct observe_on_state : std::enable_shared_from_this<observe_on_state>
         {
-            mutable std::mutex lock;
-            mutable queue_type fill_queue;
-            mutable queue_type drain_queue;
+            // pushed by the source and popped by the drain that holds processing
+            mutable queue_type queue;
+            // true while a drain is scheduled or running
+            mutable std::atomic<bool> processing;
+            // Disposed or Errored once finished
+            mutable std::atomic<int> current;
             composite_subscription lifetime;
-            mutable typename mode::type current;
             coordinator_type coordinator;
             dest_type destination;
 
             observe_on_state(dest_type d, coordinator_type coor, composite_subscription cs)
-                : lifetime(std::move(cs))
+                : processing(false)
                 , current(mode::Empty)
+                , lifetime(std::move(cs))
                 , coordinator(std::move(coor))
                 , destination(std::move(d))
             {
             }
 
-            void finish(std::unique_lock<std::mutex>& guard, typename mode::type end) const {
-                if (!guard.owns_lock()) {
-                    abort();
-                }
-                if (current == mode::Errored || current == mode::Disposed) {return;}
-                current = end;
-                queue_type fill_expired;
-                swap(fill_expired, fill_queue);
-                queue_type drain_expired;
-                swap(drain_expired, drain_queue);
-                RXCPP_UNWIND_AUTO([&](){guard.lock();});
-                guard.unlock();
+            bool is_finished() const {
+                auto c = current.load(std::memory_order_acquire);
+                return c == mode::Errored || c == mode::Disposed;
+            }
+
+            // only called while processing is held, processing is never released after this
+            void finish(typename mode::type end) const {
+                if (is_finished()) {return;}
+                current.store(end, std::memory_order_release);
+                queue.clear();
                 lifetime.unsubscribe();
                 destination.unsubscribe();
             }
 
-            void ensure_processing(std::unique_lock<std::mutex>& guard) const {
-                if (!guard.owns_lock()) {
-                    abort();
+            // schedules a drain on the transition from idle to processing
+            void ensure_processing() const {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (processing.exchange(true)) {
+                    return;
+                }
+                if (is_finished()) {
+                    return;
+                }
+                if (!lifetime.is_subscribed() && queue.empty()) {
+                    finish(mode::Disposed);
+                    return;
                 }
-                if (current == mode::Empty) {
-                    current = mode::Processing;
 
-                    if (!lifetime.is_subscribed() && fill_queue.empty() && drain_queue.empty()) {
-                        finish(guard, mode::Disposed);
-                    }
+                auto keepAlive = this->shared_from_this();
 
-                    auto keepAlive = this->shared_from_this();
-
-                    auto drain = [keepAlive, this](const rxsc::schedulable& self){
-                        using std::swap;
-                        try {
-                            for (;;) {
-                                if (drain_queue.empty() || !destination.is_subscribed()) {
-                                    std::unique_lock<std::mutex> guard(lock);
-                                    if (!destination.is_subscribed() ||
-                                        (!lifetime.is_subscribed() && fill_queue.empty() && drain_queue.empty())) {
-                                        finish(guard, mode::Disposed);
-                                        return;
-                                    }
-                                    if (drain_queue.empty()) {
-                                        if (fill_queue.empty()) {
-                                            current = mode::Empty;
-                                            return;
-                                        }
-                                        swap(fill_queue, drain_queue);
-                                    }
+                auto drain = [keepAlive, this](const rxsc::schedulable& self){
+                    try {
+                        for (std::size_t delivered = 0;;) {
+                            if (!destination.is_subscribed()) {
+                                finish(mode::Disposed);
+                                return;
+                            }
+                            if (queue.pop(destination)) {
+                                if (++delivered == batch_size) {
+                                    // keep processing and continue after the other actions on the worker
+                                    self();
+                                    return;
                                 }
-                                auto notification = std::move(drain_queue.front());
-                                drain_queue.pop_front();
-                                notification->accept(destination);
-                                std::unique_lock<std::mutex> guard(lock);
-                                self();
-                                if (lifetime.is_subscribed()) break;
+                                continue;
+                            }
+                            if (!lifetime.is_subscribed()) {
+                                finish(mode::Disposed);
+                                return;
+                            }
+                            processing.store(false);
+                            // a push or an unsubscribe that saw processing before the store is seen here
+                            std::atomic_thread_fence(std::memory_order_seq_cst);
+                            if ((queue.empty() && lifetime.is_subscribed()) || processing.exchange(true)) {
+                                return;
                             }
-                        } catch(...) {
-                            destination.on_error(std::current_exception());
-                            std::unique_lock<std::mutex> guard(lock);
-                            finish(guard, mode::Errored);
                         }
-                    };
-
-                    auto selectedDrain = on_exception(
-                        [&](){return coordinator.act(drain);},
-                        destination);
-                    if (selectedDrain.empty()) {
-                        finish(guard, mode::Errored);
-                        return;
+                    } catch(...) {
+                        destination.on_error(std::current_exception());
+                        finish(mode::Errored);
                     }
+                };
+
+                auto selectedDrain = on_exception(
+                    [&](){return coordinator.act(drain);},
+                    destination);
+                if (selectedDrain.empty()) {
+                    finish(mode::Errored);
+                    return;
+                }
 
-                    auto processor = coordinator.get_worker();
-
-                    RXCPP_UNWIND_AUTO([&](){guard.lock();});
-                    guard.unlock();
+                auto processor = coordinator.get_worker();
 
-                    processor.schedule(selectedDrain.get());
-                }
+                processor.schedule(selectedDrain.get());
             }
         };
         std::shared_ptr<observe_on_state> state;
@@ -155,22 +324,19 @@ struct observe_on
         }
 
         void on_next(source_value_type v) const {
-            std::unique_lock<std::mutex> guard(state->lock);
-            if (state->current == mode::Errored || state->current == mode::Disposed) { return; }
-            state->fill_queue.push_back(notification_type::on_next(std::move(v)));
-            state->ensure_processing(guard);
+            if (state->is_finished()) { return; }
+            state->queue.push_next(std::move(v));
+            state->ensure_processing();
         }
         void on_error(std::exception_ptr e) const {
-            std::unique_lock<std::mutex> guard(state->lock);
-            if (state->current == mode::Errored || state->current == mode::Disposed) { return; }
-            state->fill_queue.push_back(notification_type::on_error(e));
-            state->ensure_processing(guard);
+            if (state->is_finished()) { return; }
+            state->queue.push_error(e);
+            state->ensure_processing();
         }
         void on_completed() const {
-            std::unique_lock<std::mutex> guard(state->lock);
-            if (state->current == mode::Errored || state->current == mode::Disposed) { return; }
-            state->fill_queue.push_back(notification_type::on_completed());
-            state->ensure_processing(guard);
+            if (state->is_finished()) { return; }
+            state->queue.push_completed();
+            state->ensure_processing();
         }
 
         static subscriber<value_type, observer<value_type, this_type>> make(dest_type d, coordination_type cn, composite_subscription cs = composite_subscription()) {
@@ -180,8 +346,7 @@ struct observe_on
             this_type o(d, std::move(coor), cs);
             auto keepAlive = o.state;
             cs.add([=](){
-                std::unique_lock<std::mutex> guard(keepAlive->lock);
-                keepAlive->ensure_processing(guard);
+                keepAlive->ensure_processing();
             });
 
             return make_subscriber<value_type>(d, cs, make_observer<value_type>(std::move(o)));
@@ -9,10 +9,85 @@
 
 namespace rxcpp {
 
+class zip_overflow_error: public std::runtime_error
+{
+    public:
+        explicit zip_overflow_error(const std::string& msg):
+            std::runtime_error(msg)
+        {}
+};
+
 namespace operators {
 
 namespace detail {
 
+// a growable ring of values. the values are kept in one contiguous
+// allocation that doubles when full, instead of a node per value.
+template<class T>
+class zip_buffer
+{
+    typedef typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage_type;
+
+    std::unique_ptr<storage_type[]> slots;
+    std::size_t mask;
+    std::size_t first;
+    std::size_t count;
+
+    T* at(std::size_t i) {
+        return reinterpret_cast<T*>(&slots[(first + i) & mask]);
+    }
+    void grow() {
+        std::size_t capacity = slots ? (mask + 1) * 2 : 16;
+        std::unique_ptr<storage_type[]> next(new storage_type[capacity]);
+        for (std::size_t i = 0; i != count; ++i) {
+            auto v = at(i);
+            new (reinterpret_cast<T*>(&next[i])) T(std::move(*v));
+            v->~T();
+        }
+        slots = std::move(next);
+        mask = capacity - 1;
+        first = 0;
+    }
+
+public:
+    zip_buffer()
+        : mask(0)
+        , first(0)
+        , count(0)
+    {
+    }
+    zip_buffer(const zip_buffer&) = delete;
+    zip_buffer& operator=(const zip_buffer&) = delete;
+    ~zip_buffer()
+    {
+        while (count != 0) {
+            pop_front();
+        }
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+    std::size_t size() const {
+        return count;
+    }
+    T& front() {
+        return *at(0);
+    }
+    void push_back(T v) {
+        if (!slots || count == mask + 1) {
+            grow();
+        }
+        new (at(count)) T(std::move(v));
+        ++count;
+    }
+    void pop_front() {
+        at(0)->~T();
+        first = (first + 1) & mask;
+        --count;
+    }
+};
+
 template<class T>
 struct zip_source_state
 {
@@ -20,7 +95,7 @@ struct zip_source_state
         : completed(false) 
     {
     }
-    std::list<T> values;
+    zip_buffer<T> values;
     bool completed;
 };
 
@@ -83,20 +158,23 @@ struct zip : public operator_base<rxu::value_type_t<zip_traits<Coordination, Sel
 
     struct values
     {
-        values(tuple_source_type o, selector_type s, coordination_type sf)
+        values(tuple_source_type o, selector_type s, coordination_type sf, std::size_t c)
             : source(std::move(o))
             , selector(std::move(s))
             , coordination(std::move(sf))
+            , capacity(c)
         {
         }
         tuple_source_type source;
         selector_type selector;
         coordination_type coordination;
+        // the most values that are kept for one source, 0 is unbounded
+        std::size_t capacity;
     };
     values initial;
 
-    zip(coordination_type sf, selector_type s, tuple_source_type ts)
-        : initial(std::move(ts), std::move(s), std::move(sf))
+    zip(coordination_type sf, selector_type s, tuple_source_type ts, std::size_t capacity = 0)
+        : initial(std::move(ts), std::move(s), std::move(sf), capacity)
     {
     }
 
@@ -127,7 +205,12 @@ struct zip : public operator_base<rxu::value_type_t<zip_traits<Coordination, Sel
         // on_next
             [state](source_value_type st) {
                 auto& values = std::get<Index>(state->pending).values;
-                values.push_back(st);
+                if (state->capacity != 0 && values.size() >= state->capacity) {
+                    // there is no way to slow the source, so it is an error to get this far ahead
+                    state->out.on_error(std::make_exception_ptr(rxcpp::zip_overflow_error("zip source exceeded the capacity")));
+                    return;
+                }
+                values.push_back(std::move(st));
                 if (rxu::apply_to_each(state->pending, values_not_empty(), rxu::all_values_true())) {
                     auto selectedResult = rxu::apply_to_each(state->pending, extract_value_front(), state->selector);
                     state->out.on_next(selectedResult);
@@ -2400,8 +2400,8 @@ public:
         typedef rxo::detail::zip<Coordination, rxu::detail::pack, Source, T0, TN...> operator_type;
         typedef observable<typename operator_type::value_type, operator_type> observable_type;
         template<class... ObservableN>
-        observable_type operator()(const Source& src, Coordination cn, ObservableN... on) const {
-            return observable_type(operator_type(std::move(cn), rxu::pack(), std::make_tuple(src, std::move(on)...)));
+        observable_type operator()(const Source& src, std::size_t capacity, Coordination cn, ObservableN... on) const {
+            return observable_type(operator_type(std::move(cn), rxu::pack(), std::make_tuple(src, std::move(on)...), capacity));
         }
     };
 
@@ -2412,8 +2412,8 @@ public:
         typedef rxo::detail::zip<Coordination, T0, Source, TN...> operator_type;
         typedef observable<typename operator_type::value_type, operator_type> observable_type;
         template<class... ObservableN>
-        observable_type operator()(const Source& src, Coordination cn, T0 t0, ObservableN... on) const {
-            return observable_type(operator_type(std::move(cn), std::move(t0), std::make_tuple(src, std::move(on)...)));
+        observable_type operator()(const Source& src, std::size_t capacity, Coordination cn, T0 t0, ObservableN... on) const {
+            return observable_type(operator_type(std::move(cn), std::move(t0), std::make_tuple(src, std::move(on)...), capacity));
         }
     };
 
@@ -2434,8 +2434,8 @@ public:
         typedef rxo::detail::zip<identity_one_worker, Selector, Source, TN...> operator_type;
         typedef observable<typename operator_type::value_type, operator_type> observable_type;
         template<class... ObservableN>
-        observable_type operator()(const Source& src, Selector sel, ObservableN... on) const {
-            return observable_type(operator_type(identity_current_thread(), std::move(sel), std::make_tuple(src, std::move(on)...)));
+        observable_type operator()(const Source& src, std::size_t capacity, Selector sel, ObservableN... on) const {
+            return observable_type(operator_type(identity_current_thread(), std::move(sel), std::make_tuple(src, std::move(on)...), capacity));
         }
     };
 
@@ -2446,8 +2446,8 @@ public:
         typedef rxo::detail::zip<identity_one_worker, rxu::detail::pack, Source, T0, TN...> operator_type;
         typedef observable<typename operator_type::value_type, operator_type> observable_type;
         template<class... ObservableN>
-        observable_type operator()(const Source& src, ObservableN... on) const {
-            return observable_type(operator_type(identity_current_thread(), rxu::pack(), std::make_tuple(src, std::move(on)...)));
+        observable_type operator()(const Source& src, std::size_t capacity, ObservableN... on) const {
+            return observable_type(operator_type(identity_current_thread(), rxu::pack(), std::make_tuple(src, std::move(on)...), capacity));
         }
     };
     /// \endcond
@@ -2485,10 +2485,30 @@ public:
     template<class... AN>
     auto zip(AN... an) const
         /// \cond SHOW_SERVICE_MEMBERS
-        -> decltype(select_zip<this_type, rxu::types<decltype(an)...>>{}(*(this_type*)nullptr,  std::move(an)...))
+        -> decltype(select_zip<this_type, rxu::types<decltype(an)...>>{}(*(this_type*)nullptr,  std::size_t(0), std::move(an)...))
+        /// \endcond
+    {
+        return      select_zip<this_type, rxu::types<decltype(an)...>>{}(*this,                 std::size_t(0), std::move(an)...);
+    }
+
+    /*! Bring by one item from all given observables and select a value to emit from the new observable that is returned. At most capacity items are kept for each source while it waits for the others.
+
+        \tparam AN  types of scheduler (optional), aggregate function (optional), and source observables
+
+        \param  capacity  the number of items that one source may get ahead of the slowest source
+        \param  an        scheduler (optional), aggregation function (optional), and source observables
+
+        \return  Observable that emits the result of combining the items emitted and brought by one from each of the source observables, or that terminates with zip_overflow_error when a source gets more than capacity items ahead.
+
+        \note the sources cannot be slowed, so a source that exceeds the capacity is an error rather than backpressure. zip without a capacity keeps every pending item.
+    */
+    template<class... AN>
+    auto zip_bounded(std::size_t capacity, AN... an) const
+        /// \cond SHOW_SERVICE_MEMBERS
+        -> decltype(select_zip<this_type, rxu::types<decltype(an)...>>{}(*(this_type*)nullptr,  capacity, std::move(an)...))
         /// \endcond
     {
-        return      select_zip<this_type, rxu::types<decltype(an)...>>{}(*this,                 std::move(an)...);
+        return      select_zip<this_type, rxu::types<decltype(an)...>>{}(*this,                 capacity, std::move(an)...);
     }
 
     /*! Return an observable that emits grouped_observables, each of which corresponds to a unique key value and each of which emits those items from the source observable that share that key value.
@@ -2540,6 +2560,53 @@ public:
         return                    lift<typename rxo::detail::group_by_traits<T, this_type, KeySelector, MarbleSelector, rxu::less>::grouped_observable_type>(rxo::detail::group_by<T, this_type, KeySelector, MarbleSelector, rxu::less>(std::move(ks), std::move(ms), rxu::less()));
     }
 
+    /*! Return an observable that emits grouped_observables, each of which corresponds to a unique key value and each of which emits those items from the source observable that share that key value.
+
+        \tparam KeySelector     the type of the key extracting function
+        \tparam MarbleSelector  the type of the element extracting function
+
+        \param  ks  a function that extracts the key for each item
+        \param  ms  a function that extracts the return element for each item
+        \param  ev  the bound on the number of groups and the idle time after which a group is completed and dropped
+
+        \return  Observable that emits values of grouped_observable type, each of which corresponds to a unique key value and each of which emits those items from the source observable that share that key value.
+
+        \note group_by_hashed keeps the groups in an open addressing hash map instead of the std::map of group_by. keys are hashed with rxcpp::filtered_hash<key_type> and compared with ==. an evicted group is completed and a later item with the same key emits a new group.
+    */
+    template<class KeySelector, class MarbleSelector>
+    inline auto group_by_hashed(KeySelector ks, MarbleSelector ms, rxo::group_eviction ev = rxo::group_eviction()) const
+        /// \cond SHOW_SERVICE_MEMBERS
+        -> decltype(EXPLICIT_THIS lift<typename rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, identity_one_worker>::traits_type::grouped_observable_type>(rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, identity_one_worker>(std::move(ks), std::move(ms), ev, identity_current_thread(), 1)))
+        /// \endcond
+    {
+        return                    lift<typename rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, identity_one_worker>::traits_type::grouped_observable_type>(rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, identity_one_worker>(std::move(ks), std::move(ms), ev, identity_current_thread(), 1));
+    }
+
+    /*! Return an observable that emits grouped_observables, each of which corresponds to a unique key value and each of which emits those items from the source observable that share that key value.
+
+        \tparam KeySelector     the type of the key extracting function
+        \tparam MarbleSelector  the type of the element extracting function
+        \tparam Coordination    the type of the scheduler
+
+        \param  ks      a function that extracts the key for each item
+        \param  ms      a function that extracts the return element for each item
+        \param  ev      the bound on the number of groups and the idle time after which a group is completed and dropped
+        \param  cn      the scheduler that provides a worker for each shard
+        \param  shards  the number of shards that the keys are spread over by hash
+
+        \return  Observable that emits values of grouped_observable type, each of which corresponds to a unique key value and each of which emits those items from the source observable that share that key value.
+
+        \note the keys and elements are selected on the source thread. the groups of each shard are kept and emit on the worker of that shard. max_groups is split evenly over the shards.
+    */
+    template<class KeySelector, class MarbleSelector, class Coordination>
+    inline auto group_by_hashed(KeySelector ks, MarbleSelector ms, rxo::group_eviction ev, Coordination cn, std::size_t shards) const
+        /// \cond SHOW_SERVICE_MEMBERS
+        -> decltype(EXPLICIT_THIS lift<typename rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, Coordination>::traits_type::grouped_observable_type>(rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, Coordination>(std::move(ks), std::move(ms), ev, std::move(cn), shards)))
+        /// \endcond
+    {
+        return                    lift<typename rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, Coordination>::traits_type::grouped_observable_type>(rxo::detail::group_by_hashed<T, this_type, KeySelector, MarbleSelector, Coordination>(std::move(ks), std::move(ms), ev, std::move(cn), shards));
+    }
+
       /*! Do not emit any items from the source Observable, but allow termination notification (either onError or onCompleted) to pass through unchanged.
 
         \return  Observable that emits termination notification from the source observable.
@@ -53,6 +53,7 @@ namespace rxo=operators;
 #include "operators/rx-finally.hpp"
 #include "operators/rx-flat_map.hpp"
 #include "operators/rx-group_by.hpp"
+#include "operators/rx-group_by_hashed.hpp"
 #include "operators/rx-ignore_elements.hpp"
 #include "operators/rx-lift.hpp"
 #include "operators/rx-map.hpp"
@@ -48,10 +48,24 @@ class subscriber : public subscriber_base<T>
         {
         }
         template<class U>
-        void operator()(U u) {
+        void operator()(U&& u) {
+            // a T lvalue is passed on as is, so that a subject does not copy it for each observer
+            next(std::forward<U>(u), std::is_same<U, T&>());
+        }
+        template<class U>
+        void next(U&& u, std::false_type) {
+            rxu::decay_t<U> copy(std::forward<U>(u));
+            deliver(std::move(copy));
+        }
+        template<class U>
+        void next(U& u, std::true_type) {
+            deliver(u);
+        }
+        template<class U>
+        void deliver(U&& u) {
             trace_activity().on_next_enter(*that, u);
             try {
-                that->destination.on_next(std::move(u));
+                that->destination.on_next(std::forward<U>(u));
                 do_unsubscribe = false;
             } catch(...) {
                 auto ex = std::current_exception();
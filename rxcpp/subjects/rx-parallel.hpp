@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved. See License.txt in the project root for license information.
+
+#pragma once
+
+#if !defined(RXCPP_RX_PARALLEL_HPP)
+#define RXCPP_RX_PARALLEL_HPP
+
+#include "../rx-includes.hpp"
+
+namespace rxcpp {
+
+namespace subjects {
+
+// Fans each value out to the observers in parallel. The observers are
+// spread over shards. Each shard is a subject fed through observe_on, so
+// it delivers in order on its own worker from the coordination, and a
+// value is queued once per shard rather than once per observer. The
+// terminal is queued behind the values, so it does not drop them.
+template<class T, class Coordination>
+class parallel
+{
+    struct shard_type
+    {
+        // values are pushed into input, and observe_on delivers them to output
+        subject<T> input;
+        subject<T> output;
+    };
+
+    struct state_type
+    {
+        state_type()
+            : next(0)
+        {
+        }
+        std::vector<shard_type> shards;
+        std::vector<subscriber<T>> inputs;
+        // picks the shard for the next observer
+        std::atomic<std::size_t> next;
+    };
+
+    composite_subscription lifetime;
+    // the input completes before the shards have delivered
+    composite_subscription input;
+    std::shared_ptr<state_type> state;
+
+public:
+    parallel(std::size_t count, Coordination cn, composite_subscription cs = composite_subscription())
+        : lifetime(std::move(cs))
+        , state(std::make_shared<state_type>())
+    {
+        if (count == 0) {
+            count = 1;
+        }
+        state->shards.reserve(count);
+        state->inputs.reserve(count);
+        lifetime.add(input);
+        for (std::size_t i = 0; i != count; ++i) {
+            // a shard that completes must not dispose the others
+            composite_subscription in, out;
+            lifetime.add(in);
+            lifetime.add(out);
+            state->shards.push_back(shard_type{subject<T>(in), subject<T>(out)});
+            auto& shard = state->shards.back();
+            shard.input.get_observable().observe_on(cn).subscribe(shard.output.get_subscriber());
+            state->inputs.push_back(shard.input.get_subscriber().as_dynamic());
+        }
+    }
+
+    bool has_observers() const {
+        return std::any_of(state->shards.begin(), state->shards.end(),
+            [](const shard_type& s){
+                return s.output.has_observers();
+            });
+    }
+
+    subscriber<T> get_subscriber() const {
+        auto keepAlive = state;
+        return make_subscriber<T>(input,
+            [keepAlive](const T& v){
+                for (auto& i : keepAlive->inputs) {
+                    i.on_next(v);
+                }
+            },
+            [keepAlive](std::exception_ptr e){
+                for (auto& i : keepAlive->inputs) {
+                    i.on_error(e);
+                }
+            },
+            [keepAlive](){
+                for (auto& i : keepAlive->inputs) {
+                    i.on_completed();
+                }
+            }).as_dynamic();
+    }
+
+    observable<T> get_observable() const {
+        auto keepAlive = state;
+        return make_observable_dynamic<T>([=](subscriber<T> o){
+            auto& shard = keepAlive->shards[keepAlive->next++ % keepAlive->shards.size()];
+            shard.output.get_observable().subscribe(std::move(o));
+        });
+    }
+};
+
+}
+
+}
+
+#endif
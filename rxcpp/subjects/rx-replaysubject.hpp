@@ -36,11 +36,100 @@ class replay_observer : public detail::multicast_observer<T>
     typedef typename traits::coordination_type coordination_type;
     typedef typename traits::coordinator_type coordinator_type;
 
+    // A block of the replay window. The values are stored contiguously
+    // with their time points. Each slot is written once by the producer
+    // before the end of the window is published, so a snapshot can read
+    // the slots below its end without a lock.
+    struct replay_segment
+    {
+        static const std::size_t capacity = 256;
+
+        struct slot
+        {
+            slot(T v, time_point_type t)
+                : value(std::move(v))
+                , time_point(t)
+            {
+            }
+            T value;
+            time_point_type time_point;
+        };
+
+        replay_segment()
+            : written(0)
+        {
+        }
+        ~replay_segment()
+        {
+            for (std::size_t i = 0; i != written; ++i) {
+                at(i).~slot();
+            }
+        }
+
+        slot& at(std::size_t i) {
+            return *reinterpret_cast<slot*>(&slots[i]);
+        }
+        const slot& at(std::size_t i) const {
+            return *reinterpret_cast<const slot*>(&slots[i]);
+        }
+
+        typename std::aligned_storage<sizeof(slot), std::alignment_of<slot>::value>::type slots[capacity];
+        // only changed by the producer
+        std::size_t written;
+
+    private:
+        replay_segment(const replay_segment&);
+        replay_segment& operator=(const replay_segment&);
+    };
+
+    // The segments of the window. first is the sequence number of the
+    // first slot of segments.front(). Replaced when a segment is added.
+    struct replay_index
+    {
+        std::size_t first;
+        std::vector<std::shared_ptr<replay_segment>> segments;
+    };
+
+public:
+    // The values that were in the window when the snapshot was taken.
+    // Holds the segments, so the producer can keep adding and evicting.
+    class replay_snapshot
+    {
+        std::shared_ptr<const replay_index> index;
+        std::size_t begin;
+        std::size_t end;
+    public:
+        replay_snapshot(std::shared_ptr<const replay_index> i, std::size_t b, std::size_t e)
+            : index(std::move(i))
+            , begin(b)
+            , end(e)
+        {
+        }
+
+        std::size_t size() const {
+            return end - begin;
+        }
+
+        template<class F>
+        void for_each(F&& f) const {
+            for (auto sequence = begin; sequence != end; ++sequence) {
+                auto offset = sequence - index->first;
+                const auto& segment = *index->segments[offset / replay_segment::capacity];
+                f(segment.at(offset % replay_segment::capacity).value);
+            }
+        }
+    };
+
+private:
     class replay_observer_state : public std::enable_shared_from_this<replay_observer_state>
     {
+        // serializes the producers. snapshots do not take it.
         mutable std::mutex lock;
-        mutable std::list<T> values;
-        mutable std::list<time_point_type> time_points;
+        mutable std::shared_ptr<const replay_index> index;
+        mutable std::shared_ptr<replay_segment> tail;
+        // the window is the sequence numbers [begin, end)
+        mutable std::atomic<std::size_t> begin;
+        mutable std::atomic<std::size_t> end;
         mutable count_type count;
         mutable period_type period;
     public:
@@ -48,16 +137,31 @@ class replay_observer : public detail::multicast_observer<T>
         mutable coordinator_type coordinator;
 
     private:
-        void remove_oldest() const {
-            values.pop_front();
-            if (!period.empty()) {
-                time_points.pop_front();
-            }
+        const typename replay_segment::slot& slot_at(std::size_t sequence) const {
+            auto offset = sequence - index->first;
+            return index->segments[offset / replay_segment::capacity]->at(offset % replay_segment::capacity);
+        }
+
+        // called when the tail is full. the new index drops the segments 
+        // that were evicted, a snapshot that still reads them holds them.
+        void add_segment(std::size_t b) const {
+            auto next = std::make_shared<replay_index>();
+            next->first = index->first;
+            auto evicted = (b - index->first) / replay_segment::capacity;
+            next->first += evicted * replay_segment::capacity;
+            next->segments.reserve(index->segments.size() - evicted + 1);
+            next->segments.assign(index->segments.begin() + evicted, index->segments.end());
+            tail = std::make_shared<replay_segment>();
+            next->segments.push_back(tail);
+            std::atomic_store(&index, std::shared_ptr<const replay_index>(std::move(next)));
         }
 
     public:
         explicit replay_observer_state(count_type _count, period_type _period, coordination_type _coordination, coordinator_type _coordinator)
-            : count(_count)
+            : index(std::make_shared<replay_index>())
+            , begin(0)
+            , end(0)
+            , count(_count)
             , period(_period)
             , coordination(std::move(_coordination))
             , coordinator(std::move(_coordinator))
@@ -66,22 +170,44 @@ class replay_observer : public detail::multicast_observer<T>
 
         void add(T v) const {
             std::unique_lock<std::mutex> guard(lock);
+            auto b = begin.load(std::memory_order_relaxed);
+            auto e = end.load(std::memory_order_relaxed);
             if (!count.empty()) {
-                if (values.size() == count.get())
-                    remove_oldest();
+                if (e - b == count.get())
+                    ++b;
             }
 
+            time_point_type now;
             if (!period.empty()) {
-                auto now = coordination.now();
-                while (!time_points.empty() && (now - time_points.front() > period.get()))
-                    remove_oldest();
-                time_points.push_back(now);
+                now = coordination.now();
+                while (b != e && (now - slot_at(b).time_point > period.get()))
+                    ++b;
+            }
+
+            if (!tail || tail->written == replay_segment::capacity) {
+                add_segment(b);
             }
+            new (&tail->slots[tail->written]) typename replay_segment::slot(std::move(v), now);
+            ++tail->written;
 
-            values.push_back(std::move(v));
+            begin.store(b, std::memory_order_release);
+            end.store(e + 1, std::memory_order_release);
         }
+
+        replay_snapshot snapshot() const {
+            // the index is published before end moves into a new segment
+            auto e = end.load(std::memory_order_acquire);
+            auto i = std::atomic_load(&index);
+            auto b = begin.load(std::memory_order_acquire);
+            b = std::min(std::max(b, i->first), e);
+            return replay_snapshot(std::move(i), b, e);
+        }
+
         std::list<T> get() const {
-            std::unique_lock<std::mutex> guard(lock);
+            std::list<T> values;
+            snapshot().for_each([&](const T& v){
+                values.push_back(v);
+            });
             return values;
         }
     };
@@ -104,6 +230,10 @@ public:
         return state->get();
     }
 
+    replay_snapshot get_snapshot() const {
+        return state->snapshot();
+    }
+
     coordinator_type& get_coordinator() const {
         return state->coordinator;
     }
@@ -156,6 +286,11 @@ public:
         return s.get_values();
     }
 
+    // the values in the window, without copying them or blocking the producer
+    typename detail::replay_observer<T, Coordination>::replay_snapshot get_snapshot() const {
+        return s.get_snapshot();
+    }
+
     subscriber<T> get_subscriber() const {
         return s.get_subscriber();
     }
@@ -164,8 +299,9 @@ public:
         auto keepAlive = s;
         auto observable = make_observable_dynamic<T>([=](subscriber<T> o){
             if (keepAlive.get_subscription().is_subscribed()) {
-                for (auto&& value: get_values())
+                keepAlive.get_snapshot().for_each([&](const T& value){
                     o.on_next(value);
+                });
             }
             keepAlive.add(keepAlive.get_subscriber(), std::move(o));
         });
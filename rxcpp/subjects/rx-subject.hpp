@@ -36,12 +36,15 @@ class multicast_observer
         explicit state_type(composite_subscription cs)
             : generation(0)
             , current(mode::Casting)
+            , removed(0)
             , lifetime(cs)
         {
         }
         std::atomic<int> generation;
         std::mutex lock;
         typename mode::type current;
+        // the observers in completer that have unsubscribed since it was built
+        std::size_t removed;
         std::exception_ptr error;
         composite_subscription lifetime;
     };
@@ -131,7 +134,11 @@ public:
     }
     bool has_observers() const {
         std::unique_lock<std::mutex> guard(b->state->lock);
-        return b->current_completer && !b->current_completer->observers.empty();
+        return b->completer && std::any_of(
+            b->completer->observers.begin(), b->completer->observers.end(),
+            [](const observer_type& o){
+                return o.is_subscribed();
+            });
     }
     template<class SubscriberFrom>
     void add(const SubscriberFrom& sf, observer_type o) const {
@@ -146,11 +153,21 @@ public:
                         auto b = binder.lock();
                         if (b) {
                             std::unique_lock<std::mutex> guard(b->state->lock);
+                            if (!b->completer) {
+                                return;
+                            }
+                            // on_next skips the observer until the observers are copied.
+                            // copying once half have unsubscribed keeps churn amortized O(1)
+                            if (++b->state->removed * 2 < b->completer->observers.size()) {
+                                return;
+                            }
                             b->completer = std::make_shared<completer_type>(b->state, b->completer);
+                            b->state->removed = 0;
                             ++b->state->generation;
                         }
                     });
                     b->completer = std::make_shared<completer_type>(b->state, b->completer, o);
+                    b->state->removed = 0;
                     ++b->state->generation;
                 }
             }
@@ -181,8 +198,9 @@ public:
             abort();
         }
     }
+    // each observer is passed the same value, it is not copied per observer
     template<class V>
-    void on_next(V v) const {
+    void on_next(V&& v) const {
         if (b->current_generation != b->state->generation) {
             std::unique_lock<std::mutex> guard(b->state->lock);
             b->current_generation = b->state->generation;
@@ -2,72 +2,120 @@
 
 namespace rx {
 
-const auto merge = [](auto makeStrand){
-    info("new merge");
+namespace detail {
+
+/// the inputs of merge. only used on the shared strand
+struct merge_state
+{
+    merge_state() : inners(0), starting(false) {}
+    /// the source and the inners that have not stopped
+    set<subscription> pending;
+    /// the number of inners that have been subscribed and not stopped
+    size_t inners;
+    /// the inners that wait for one of the subscribed inners to stop
+    deque<function<void()>> waiting;
+    /// true while waiting inners are being subscribed
+    bool starting;
+};
+
+}
+
+/// \brief merges the values of the observables from source.
+/// at most max_concurrent inner observables are subscribed at once, 
+/// the rest wait in order and are subscribed as earlier ones stop.
+const auto merge = [](auto makeStrand, size_t max_concurrent = numeric_limits<size_t>::max()){
+    RX_TRACE("new merge");
     return make_adaptor([=](auto source){
-        info("merge bound to source");
+        RX_TRACE("merge bound to source");
         auto sharedmakestrand = make_shared_make_strand(makeStrand);
-        info("merge-input start");
+        RX_TRACE("merge-input start");
         return source |
             observe_on(sharedmakestrand) |
             make_lifter([=](auto scrb) {
-                info("merge bound to subscriber");
+                RX_TRACE("merge bound to subscriber");
                 return make_subscriber([=](auto ctx){
-                    info("merge bound to context lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(ctx.lifetime.store.get())));
+                    RX_TRACE(ctx.lifetime.store.get(), "merge bound to context lifetime");
                     
                     auto sourcecontext = make_context(subscription{}, sharedmakestrand);
 
-                    auto pending = make_state<set<subscription>>(ctx.lifetime);
+                    auto state = make_state<detail::merge_state>(ctx.lifetime);
 
-                    auto& pends = pending.get();
-                    ctx.lifetime.insert([&pends](){
-                        info("merge-output stopping all inputs");
+                    auto& ms = state.get();
+                    ctx.lifetime.insert([&ms](){
+                        RX_TRACE("merge-output stopping all inputs");
+                        ms.waiting.clear();
                         // stop all the inputs
-                        for (auto& l : pends) {
+                        for (auto& l : ms.pending) {
                             l.stop();
                         }
-                        pends.clear();
-                        info("merge-output stop");
+                        ms.pending.clear();
+                        RX_TRACE("merge-output stop");
                     });
 
                     auto destctx = copy_context(ctx.lifetime, sharedmakestrand, ctx);
                     auto r = scrb.create(destctx);
 
-                    auto it = pending.get().insert(sourcecontext.lifetime).first;
-                    sourcecontext.lifetime.insert([=, &pends](){
-                        pends.erase(it);
-                        if (pends.empty()){
-                            info("merge-input complete destination");
+                    auto it = ms.pending.insert(sourcecontext.lifetime).first;
+                    sourcecontext.lifetime.insert([=, &ms](){
+                        ms.pending.erase(it);
+                        if (ms.pending.empty() && ms.waiting.empty()){
+                            RX_TRACE("merge-input complete destination");
                             r.complete();
                         }
-                        info("merge-input stop");
+                        RX_TRACE("merge-input stop");
                     });
 
-                    info("merge-input observer lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(sourcecontext.lifetime.store.get())));
+                    // subscribes waiting inners until max_concurrent are subscribed.
+                    // an inner that stops while this runs is replaced by the loop
+                    // instead of by a nested call
+                    auto start_waiting = [&ms, max_concurrent](){
+                        if (ms.starting) return;
+                        ms.starting = true;
+                        while (!ms.waiting.empty() && ms.inners < max_concurrent) {
+                            auto next = move(ms.waiting.front());
+                            ms.waiting.pop_front();
+                            next();
+                        }
+                        ms.starting = false;
+                    };
+
+                    auto start_nested = [=, &ms](auto& r, auto& v){
+                        RX_TRACE("merge-nested start");
+                        auto nestedcontext = make_context(subscription{}, sharedmakestrand);
+                        // the inners share the credit of the destination
+                        nestedcontext.lifetime.bind_demand(r.lifetime.demand());
+                        auto it = ms.pending.insert(nestedcontext.lifetime).first;
+                        ++ms.inners;
+                        nestedcontext.lifetime.insert([=, &ms](){
+                            ms.pending.erase(it);
+                            --ms.inners;
+                            start_waiting();
+                            if (ms.pending.empty() && ms.waiting.empty()){
+                                RX_TRACE("merge-nested complete destination");
+                                r.complete();
+                            }
+                            RX_TRACE("merge-nested stop");
+                        });
+                        v |
+                            observe_on(sharedmakestrand) |
+                            make_subscriber([=](auto ctx){
+                                RX_TRACE(ctx.lifetime.store.get(), "merge-nested bound to context lifetime");
+                                RX_TRACE(ctx.lifetime.store.get(), "merge-nested observer lifetime");
+                                return make_observer(r, ctx.lifetime, 
+                                    [](auto& r, auto&& v){
+                                        r.next(std::forward<decltype(v)>(v));
+                                    }, detail::pass{}, detail::skip{});
+                            }) | 
+                            start(nestedcontext);
+                    };
+
+                    RX_TRACE(sourcecontext.lifetime.store.get(), "merge-input observer lifetime");
                     return make_observer(r, sourcecontext.lifetime, 
-                        [=, &pends](auto& r, auto& v){
-                            info("merge-nested start");
-                            auto nestedcontext = make_context(subscription{}, sharedmakestrand);
-                            auto it = pends.insert(nestedcontext.lifetime).first;
-                            nestedcontext.lifetime.insert([=, &pends](){
-                                pends.erase(it);
-                                if (pends.empty()){
-                                    info("merge-nested complete destination");
-                                    r.complete();
-                                }
-                                info("merge-nested stop");
+                        [=, &ms](auto& r, auto& v){
+                            ms.waiting.push_back([=](){
+                                start_nested(r, v);
                             });
-                            v |
-                                observe_on(sharedmakestrand) |
-                                make_subscriber([=](auto ctx){
-                                    info("merge-nested bound to context lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(ctx.lifetime.store.get())));
-                                    info("merge-nested observer lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(ctx.lifetime.store.get())));
-                                    return make_observer(r, ctx.lifetime, 
-                                        [](auto& r, auto& v){
-                                            r.next(v);
-                                        }, detail::pass{}, detail::skip{});
-                                }) | 
-                                start(nestedcontext);
+                            start_waiting();
                         }, detail::pass{}, detail::skip{});
                 });
             });
@@ -0,0 +1,306 @@
+#pragma once
+
+namespace rx {
+
+namespace detail {
+
+///
+/// \brief the values of one inner observable of merge_sharded.
+/// the inner is the only producer and the output strand the only consumer.
+/// values are written to a queue that is made for the type of the first
+/// value. once a value of another type arrives, that value and every later
+/// value are queued as closures, so the order is kept.
+///
+struct merge_shard
+{
+    merge_shard()
+        : next(nullptr)
+        , queued(false)
+        , type(nullptr)
+        , closures(nullptr)
+        , done(false)
+        , finished(false) {
+    }
+    ~merge_shard() {
+        delete closures.load(memory_order_acquire);
+    }
+    /// links the shard into the ready stack
+    merge_shard* next;
+    /// held while the shard is in the ready stack
+    shared_ptr<merge_shard> keep;
+    /// true while the shard is in the ready stack
+    atomic<bool> queued;
+
+    const type_info* type;
+    shared_ptr<void> values;
+    /// delivers up to n values. \returns the number delivered.
+    function<size_t(size_t)> drain_values;
+    atomic<spsc_queue<function<void()>>*> closures;
+
+    function<void()> terminal;
+    atomic<bool> done;
+    /// only used by the consumer
+    bool finished;
+
+    /// \brief delivers up to n values. only called by the consumer.
+    size_t drain(size_t n) {
+        size_t delivered = drain_values ? drain_values(n) : 0;
+        auto c = closures.load(memory_order_acquire);
+        while (c && delivered < n && !c->empty()) {
+            // the typed values were all queued before the first closure
+            if (drain_values) {
+                delivered += drain_values(n - delivered);
+            }
+            if (delivered >= n || !c->consume([](function<void()>&& f){ f(); })) {
+                break;
+            }
+            ++delivered;
+        }
+        return delivered;
+    }
+};
+
+///
+/// \brief the state shared by the inputs and the output of merge_sharded.
+/// pending counts the source and the inner observables that have not
+/// finished. ready is an intrusive stack of the shards that have values
+/// or have finished. one deferred drain on the output strand delivers them.
+///
+struct merge_sharded_state
+{
+    explicit merge_sharded_state(size_t capacity)
+        : capacity(capacity)
+        , pending(1)
+        , source_done(false)
+        , source_finished(false)
+        , scheduled(false) {
+    }
+    ~merge_sharded_state() {
+        // release the shards that were not drained
+        for (auto s = ready.close(); s; ) {
+            auto next = s->next;
+            s->keep.reset();
+            s = next;
+        }
+    }
+    const size_t capacity;
+    atomic<size_t> pending;
+    atomic_stack<merge_shard> ready;
+
+    function<void()> source_terminal;
+    atomic<bool> source_done;
+    /// only used by the consumer
+    bool source_finished;
+
+    /// true while a drain is deferred or running
+    atomic<bool> scheduled;
+
+    /// \brief adds the shard to the ready stack unless it is already there.
+    /// \returns true when the shard was added.
+    bool ready_shard(const shared_ptr<merge_shard>& s) {
+        if (s->queued.exchange(true)) {
+            return false;
+        }
+        s->keep = s;
+        if (!ready.push(s.get())) {
+            // the merge was stopped
+            s->keep.reset();
+        }
+        return true;
+    }
+};
+
+}
+
+///
+/// \brief a merge for the fan-in of many concurrent inner observables.
+/// each inner is subscribed on its own strand from makeStrand and writes its
+/// values to its own lock-free queue. the output strand drains the queues,
+/// delivering up to capacity values before it lets other work on the strand run.
+/// unlike merge, the inputs do not contend on a shared strand or a lock.
+///
+template<class MakeStrand>
+auto merge_sharded(MakeStrand makeStrand, size_t capacity = 1024){
+    RX_TRACE("new merge_sharded");
+    return make_adaptor([=](auto source){
+        RX_TRACE("merge_sharded bound to source");
+        return make_observable([=](auto scrb){
+            RX_TRACE("merge_sharded bound to subscriber");
+            return source.bind(
+                make_subscriber([=](auto ctx){
+                    RX_TRACE(ctx.lifetime.store.get(), "merge_sharded bound to context lifetime");
+                    auto outcontext = copy_context(ctx.lifetime, makeStrand, ctx);
+                    auto r = scrb.create(outcontext);
+                    // the inners may still be running on other threads when the output stops
+                    auto st = make_shared<detail::merge_sharded_state>(capacity);
+
+                    // stopping the output stops the source and the inners
+                    auto sourcecontext = make_context(subscription{}, makeStrand);
+                    ctx.lifetime.insert(sourcecontext.lifetime);
+
+                    auto drain = [=](auto& r, auto& self){
+                        auto& s = *st;
+                        size_t delivered = 0;
+                        for (;;) {
+                            // the stack is LIFO, deliver the shards in the order they were readied
+                            detail::merge_shard* chain = nullptr;
+                            for (auto n = s.ready.take(); n; ) {
+                                auto next = n->next;
+                                n->next = chain;
+                                chain = n;
+                                n = next;
+                            }
+                            while (chain) {
+                                auto shard = chain;
+                                chain = chain->next;
+                                auto hold = move(shard->keep);
+                                // the exchange acquires the values and the done flag of the producer
+                                shard->queued.exchange(false);
+                                if (r.lifetime.is_stopped()) {
+                                    continue;
+                                }
+                                delivered += shard->drain(s.capacity > delivered ? s.capacity - delivered : 0);
+                                if (delivered >= s.capacity) {
+                                    // the shard may have more values
+                                    s.ready_shard(hold);
+                                    continue;
+                                }
+                                if (shard->done.load(memory_order_acquire) && !shard->finished) {
+                                    // drain the values that were queued before done
+                                    while (shard->drain(s.capacity) > 0) {}
+                                    shard->finished = true;
+                                    if (shard->terminal) {
+                                        shard->terminal();
+                                        return;
+                                    }
+                                    --s.pending;
+                                }
+                            }
+                            if (s.source_done.load(memory_order_acquire) && !s.source_finished) {
+                                s.source_finished = true;
+                                if (s.source_terminal) {
+                                    s.source_terminal();
+                                    return;
+                                }
+                                --s.pending;
+                            }
+                            if (s.pending == 0) {
+                                RX_TRACE("merge_sharded complete destination");
+                                r.complete();
+                                return;
+                            }
+                            if (r.lifetime.is_stopped()) {
+                                return;
+                            }
+                            if (delivered >= s.capacity) {
+                                // let other work on the strand run
+                                self(outcontext.now());
+                                return;
+                            }
+                            s.scheduled = false;
+                            atomic_thread_fence(memory_order_seq_cst);
+                            auto more = s.ready.peek() || (s.source_done && !s.source_finished);
+                            if (!more || s.scheduled.exchange(true)) {
+                                return;
+                            }
+                        }
+                    };
+
+                    auto schedule = [=](){
+                        auto& s = *st;
+                        atomic_thread_fence(memory_order_seq_cst);
+                        if (!s.scheduled.exchange(true)) {
+                            defer(outcontext, make_observer(r, subscription{}, drain, detail::pass{}, detail::skip{}));
+                        }
+                    };
+
+                    RX_TRACE(sourcecontext.lifetime.store.get(), "merge_sharded-input observer lifetime");
+                    return make_observer(r, sourcecontext.lifetime,
+                        [=](auto& r, auto& v){
+                            RX_TRACE("merge_sharded-nested start");
+                            auto& s = *st;
+                            auto shard = make_shared<detail::merge_shard>();
+                            ++s.pending;
+                            auto nestedcontext = make_context(subscription{}, makeStrand);
+                            ctx.lifetime.insert(nestedcontext.lifetime);
+                            // the inners share the credit of the destination
+                            nestedcontext.lifetime.bind_demand(r.lifetime.demand());
+                            // the shard is finished when the inner stops, whether or 
+                            // not it completed, so a stopped inner does not hang the merge
+                            nestedcontext.lifetime.insert([=](){
+                                RX_TRACE("merge_sharded-nested stop");
+                                shard->done.store(true, memory_order_release);
+                                if (!r.lifetime.is_stopped() && st->ready_shard(shard)) {
+                                    schedule();
+                                }
+                            });
+                            v |
+                                make_subscriber([=](auto ctx){
+                                    RX_TRACE(ctx.lifetime.store.get(), "merge_sharded-nested observer lifetime");
+                                    return make_observer(ctx.lifetime,
+                                        [=](auto v){
+                                            using value_type = decltype(v);
+                                            auto& sh = *shard;
+                                            if (!sh.type) {
+                                                auto q = make_shared<detail::spsc_queue<value_type>>();
+                                                sh.type = &typeid(value_type);
+                                                sh.values = q;
+                                                sh.drain_values = [q, r](size_t n){
+                                                    size_t count = 0;
+                                                    while (count < n && q->consume([&](value_type&& v){ r.next(move(v)); })) {
+                                                        ++count;
+                                                    }
+                                                    return count;
+                                                };
+                                            }
+                                            auto c = sh.closures.load(memory_order_relaxed);
+                                            if (!c && (sh.type == &typeid(value_type) || *sh.type == typeid(value_type))) {
+                                                static_cast<detail::spsc_queue<value_type>*>(sh.values.get())->push(move(v));
+                                            } else {
+                                                if (!c) {
+                                                    c = new detail::spsc_queue<function<void()>>();
+                                                    sh.closures.store(c, memory_order_release);
+                                                }
+                                                c->push([r, v = move(v)]() mutable {
+                                                    r.next(move(v));
+                                                });
+                                            }
+                                            if (st->ready_shard(shard)) {
+                                                schedule();
+                                            }
+                                        },
+                                        [=](auto e){
+                                            shard->terminal = [r, e](){
+                                                r.error(e);
+                                            };
+                                            shard->done.store(true, memory_order_release);
+                                            if (st->ready_shard(shard)) {
+                                                schedule();
+                                            }
+                                        },
+                                        [=](){
+                                            RX_TRACE("merge_sharded-nested complete");
+                                            // the stop of the inner finishes the shard
+                                        });
+                                }) |
+                                start(nestedcontext);
+                        },
+                        [=](auto& , auto e){
+                            auto& s = *st;
+                            s.source_terminal = [r, e](){
+                                r.error(e);
+                            };
+                            s.source_done.store(true, memory_order_release);
+                            schedule();
+                        },
+                        [=](auto& ){
+                            RX_TRACE("merge_sharded-input complete");
+                            st->source_done.store(true, memory_order_release);
+                            schedule();
+                        });
+                }));
+        });
+    });
+}
+
+}
@@ -2,25 +2,101 @@
 
 namespace rx {
 
+namespace detail {
+
+///
+/// \brief moves the credit of the destination of take to the producer.
+/// no more than the count that take passes on is moved, and the credit 
+/// that is available when the destination requests is moved with one request.
+///
+struct take_demand
+{
+    take_demand(const shared_ptr<demand>& down, size_t limit)
+        : down(down)
+        , up(make_shared<demand>())
+        , limit(limit)
+        , granted(0) {
+    }
+    const weak_ptr<demand> down;
+    const shared_ptr<demand> up;
+    const size_t limit;
+
+    mutex lock;
+    size_t granted;
+
+    static void forward(const shared_ptr<take_demand>& self) {
+        for (;;) {
+            auto d = self->down.lock();
+            if (!d) {
+                return;
+            }
+            size_t moved = 0;
+            bool full = false;
+            {
+                unique_lock<mutex> guard(self->lock);
+                moved = d->try_take(self->limit - self->granted);
+                self->granted += moved;
+                full = self->granted == self->limit;
+            }
+            if (moved > 0) {
+                self->up->request(moved);
+            }
+            weak_ptr<take_demand> weak = self;
+            if (full || d->park([weak](){
+                    if (auto s = weak.lock()) {
+                        forward(s);
+                    }
+                })) {
+                return;
+            }
+        }
+    }
+};
+
+}
+
+/// \brief passes on the first n values and completes.
+/// when the destination has opted in to demand, the producer is asked 
+/// for no more than n values.
 const auto take = [](int n){
-    info("new take");
+    RX_TRACE("new take");
     return make_adaptor([=](auto source){
-        info("take bound to source");
+        RX_TRACE("take bound to source");
         return make_observable([=](auto scrb){
-            info("take bound to subscriber");
+            RX_TRACE("take bound to subscriber");
             return source.bind(
                 make_subscriber([=](auto ctx){
-                    info("take bound to context lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(ctx.lifetime.store.get())));
+                    RX_TRACE(ctx.lifetime.store.get(), "take bound to context lifetime");
                     auto r = scrb.create(ctx);
+                    auto lifetime = r.lifetime;
+                    if (auto down = r.lifetime.demand()) {
+                        // the producer sees the clamped credit
+                        lifetime = subscription{};
+                        r.lifetime.insert(lifetime);
+                        auto credit = make_shared<detail::take_demand>(down, n > 0 ? n : 0);
+                        lifetime.bind_demand(credit->up);
+                        lifetime.insert([credit](){
+                            credit->up->close();
+                        });
+                        detail::take_demand::forward(credit);
+                    }
                     auto remaining = make_state<int>(r.lifetime, n);
-                    info("take observer lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(r.lifetime.store.get())));
-                    auto lifted = make_observer(r, r.lifetime,
-                        [remaining](auto& r, auto v){
-                            r.next(v);
+                    RX_TRACE(lifetime.store.get(), "take observer lifetime");
+                    auto lifted = make_observer(r, lifetime, detail::make_batched(
+                        [remaining](auto& r, auto&& v){
+                            r.next(std::forward<decltype(v)>(v));
                             if (--remaining.get() == 0) {
                                 r.complete();
                             }
-                        });
+                        },
+                        [remaining](auto& r, auto values){
+                            auto taken = values.first(remaining.get());
+                            r.next_batch(taken);
+                            remaining.get() -= static_cast<int>(taken.size());
+                            if (remaining.get() == 0) {
+                                r.complete();
+                            }
+                        }));
                     if (n == 0) {
                         lifted.complete();
                     }
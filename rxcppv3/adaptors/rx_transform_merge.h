@@ -2,9 +2,10 @@
 
 namespace rx {
 
+/// at most max_concurrent of the observables returned from f are subscribed at once
 template<class MakeStrand, class F>
-auto transform_merge(MakeStrand&& makeStrand, F&& f) {
-    return transform(forward<F>(f)) | merge(forward<MakeStrand>(makeStrand));
+auto transform_merge(MakeStrand&& makeStrand, F&& f, size_t max_concurrent = numeric_limits<size_t>::max()) {
+    return transform(forward<F>(f)) | merge(forward<MakeStrand>(makeStrand), max_concurrent);
 };
 
 }
\ No newline at end of file
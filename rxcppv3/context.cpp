@@ -1,13 +1,16 @@
 
 // source ~/source/emsdk_portable/emsdk_env.sh
 
-// em++ -std=c++14 --memory-init-file 0 -s ASSERTIONS=2 -s DEMANGLE_SUPPORT=1 -s DISABLE_EXCEPTION_CATCHING=0 -s NO_EXIT_RUNTIME=1 -s AGGRESSIVE_VARIABLE_ELIMINATION=1 -s EXPORT_NAME="'ContextLib'" -s MODULARIZE=1 -DRX_INFO=0 -DRX_SKIP_TESTS=0 -DRX_SKIP_THREAD=1 -DRX_SLOW=0 -DRX_DEFER_IMMEDIATE=0 -O2 -g4 context.cpp -o context.js
+// em++ -std=c++14 --memory-init-file 0 -s ASSERTIONS=2 -s DEMANGLE_SUPPORT=1 -s DISABLE_EXCEPTION_CATCHING=0 -s NO_EXIT_RUNTIME=1 -s AGGRESSIVE_VARIABLE_ELIMINATION=1 -s EXPORT_NAME="'ContextLib'" -s MODULARIZE=1 -DRX_INFO=0 -DRX_SKIP_TESTS=0 -DRX_SKIP_THREAD=1 -DRX_SLOW=0 -DRX_DEFER_IMMEDIATE=0 -DRX_LOCKFREE_SUBSCRIPTION=0 -O2 -g4 context.cpp -o context.js
 
-// c++ -std=c++14 -DRX_INFO=0 -DRX_SKIP_TESTS=0 -DRX_SKIP_THREAD=0 -DRX_SLOW=0 -DRX_DEFER_IMMEDIATE=0 -O2 context.cpp -o context
+// c++ -std=c++14 -DRX_INFO=0 -DRX_SKIP_TESTS=0 -DRX_SKIP_THREAD=0 -DRX_SLOW=0 -DRX_DEFER_IMMEDIATE=0 -DRX_LOCKFREE_SUBSCRIPTION=0 -O2 context.cpp -o context
 
 #if EMSCRIPTEN
 #include <emscripten.h>
 #include <emscripten/html5.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
 #endif
 
 #include <set>
@@ -15,6 +18,7 @@
 #include <list>
 #include <string>
 #include <iostream>
+#include <fstream>
 #include <iomanip>
 #include <exception>
 
@@ -112,6 +116,9 @@ int EMSCRIPTEN_KEEPALIVE main() {
 
 int main() {
     designcontext(0, 100);
+#if RX_INFO == 2
+    rx::trace::dump(cout);
+#endif
     loop.run();
 
     return 0;
@@ -14,14 +14,111 @@ struct cstr_or_string {
     void operator()(const string& s) const {cout <<  "string - " << s << endl;}
 };
 
+/// a buffer that counts how often it is copied
+struct counted_buffer {
+    static int copies;
+    explicit counted_buffer(size_t size) : bytes(size) {}
+    counted_buffer(const counted_buffer& o) : bytes(o.bytes) {++copies;}
+    counted_buffer(counted_buffer&&) = default;
+    counted_buffer& operator=(const counted_buffer& o) {bytes = o.bytes; ++copies; return *this;}
+    counted_buffer& operator=(counted_buffer&&) = default;
+    vector<uint8_t> bytes;
+};
+int counted_buffer::copies = 0;
+
+const auto buffers = [](int count, size_t size){
+    return make_observable([=](auto scrb){
+        return make_starter([=](auto ctx) {
+            auto r = scrb.create(ctx);
+            for (auto i = 0; i < count && !r.lifetime.is_stopped(); ++i) {
+                r.next(counted_buffer(size));
+            }
+            r.complete();
+            return ctx.lifetime;
+        });
+    });
+};
+
+const auto increment = [](int v){ return v + 1; };
+
+/// hides a lifter from fusion so that each lifter in a chain makes its own observer
+const auto unfused = [](auto l){
+    return make_lifter([=](auto scbr){
+        return l.lift(scbr);
+    });
+};
+
+/// a chain of Depth transforms
+template<int Depth>
+struct increments {
+    static auto fused() {
+        return rx::transform(increment) | increments<Depth - 1>::fused();
+    }
+    static auto lifted() {
+        return unfused(rx::transform(increment)) | increments<Depth - 1>::lifted();
+    }
+};
+template<>
+struct increments<1> {
+    static auto fused() {
+        return rx::transform(increment);
+    }
+    static auto lifted() {
+        return unfused(rx::transform(increment));
+    }
+};
+
+template<class Chain>
+double values_per_second(int first, int last, Chain chain) {
+    int result = 0;
+ auto t0 = high_resolution_clock::now();
+    ints(first, last) |
+        chain |
+        last_or_default(42) |
+        make_subscriber([&](auto ctx) {
+            return make_observer(ctx.lifetime, [&](int v) {
+                result = v;
+            });
+        }) |
+        start();
+ auto t1 = high_resolution_clock::now();
+    if (result == 42) cout << "no values" << endl;
+    return (last - first) / (duration_cast<microseconds>(t1-t0).count() / 1000000.0);
+}
+
+template<int Depth>
+void fusion(int first, int last) {
+    cout << "depth " << setw(2) << Depth 
+        << " - " << values_per_second(first, last, increments<Depth>::fused()) << " fused"
+        << " - " << values_per_second(first, last, increments<Depth>::lifted()) << " lifted"
+        << " values per second" << endl;
+}
+
+#if !EMSCRIPTEN && !RX_INFO && !RX_SKIP_TESTS && !RX_SKIP_THREAD
+/// the resident set size of the process now. 
+/// where that is not available, the peak is used.
+long rss_kb() {
+#if __linux__
+    long size = 0, resident = 0;
+    ifstream statm("/proc/self/statm");
+    if (statm >> size >> resident) {
+        return resident * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+#endif
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+#endif
+
 const auto text = [](){
-    info("new text");
+    RX_TRACE("new text");
     return make_observable([=](auto scrb){
-        info("text bound to subscriber");
+        RX_TRACE("text bound to subscriber");
         return make_starter([=](auto ctx) {
-            info("text bound to context");
+            RX_TRACE("text bound to context");
             auto r = scrb.create(ctx);
-            info("text started");
+            RX_TRACE("text started");
             r.next("hello");
             r.next(string("world"));
             r.complete();
@@ -415,6 +512,116 @@ cout << endl;
  cout << sc / s << " values per second\n"; 
 }
 
+{
+ cout << "copies of a stateful observer interface" << endl;
+    int counted = 0;
+    auto counter = make_observer(subscription{}, [&counted, count = 0](int) mutable {
+        counted = ++count;
+    }).as_interface<int>();
+    auto copy = counter;
+    counter.next(1);
+    copy.next(2);
+    cout << "the copy counted " << counted << (counted == 2 ? " - shared" : " - not shared - FAILED") << endl;
+}
+
+{
+ cout << "move 1MB buffers through 6 stages" << endl;
+    counted_buffer::copies = 0;
+    size_t received = 0;
+ auto t0 = high_resolution_clock::now();
+    buffers(last * 10 - first, 1 << 20) |
+        transform([](counted_buffer b) {
+            b.bytes[0] = 1;
+            return b;
+        }) |
+        copy_if([](const counted_buffer& b) {
+            return b.bytes[0] == 1;
+        }) |
+        transform([](counted_buffer&& b) {
+            b.bytes[1] = 2;
+            return move(b);
+        }) |
+        // a functor that takes an lvalue is passed one
+        transform([](counted_buffer& b) {
+            b.bytes[2] = 3;
+            return move(b);
+        }) |
+        take(last * 10 - first) |
+        as_interface<counted_buffer>() |
+        make_subscriber([&](auto ctx) {
+            return make_observer(ctx.lifetime, [&](auto&& b) {
+                received += b.bytes.size();
+            });
+        }) |
+        start();
+
+ auto t1 = high_resolution_clock::now();
+ auto d = duration_cast<milliseconds>(t1-t0).count() * 1.0;
+ auto sc = last * 10 - first;
+ cout << counted_buffer::copies << " copies of " << sc << " buffers (" << (received >> 20) << "MB)\n";
+ cout << d / sc << " ms per buffer\n"; 
+ auto s = d / 1000.0;
+ cout << sc / s << " buffers per second\n"; 
+}
+
+{
+ cout << "batched ints through copy_if, transform and last_or_default" << endl;
+    int result = 0;
+ auto t0 = high_resolution_clock::now();
+    ints(first, last * 100) |
+        copy_if(even) |
+        transform([](int v){ return v / 2; }) |
+        last_or_default(42) |
+        make_subscriber([&](auto ctx) {
+            return make_observer(ctx.lifetime, [&](int v) {
+                result = v;
+            });
+        }) |
+        start();
+
+ auto t1 = high_resolution_clock::now();
+    int expected = 42;
+    for (int i = first; i <= last * 100; ++i) {
+        if (even(i)) expected = i / 2;
+    }
+ auto t2 = high_resolution_clock::now();
+ auto sc = (last * 100) - first;
+ auto s = duration_cast<microseconds>(t1-t0).count() / 1000000.0;
+ cout << result << " - " << sc / s << " values per second\n";
+ auto rs = duration_cast<microseconds>(t2-t1).count() / 1000000.0;
+ cout << expected << " - " << sc / rs << " values per second in a raw loop\n";
+}
+
+{
+ cout << "a step that throws in the middle of a batch" << endl;
+    auto thrown = [=](auto lifter, const char* name){
+        int count = 0;
+        bool failed = false;
+        ints(1, 1000) |
+            lifter |
+            make_subscriber([&](auto ctx) {
+                return make_observer(ctx.lifetime, 
+                    [&](int) { ++count; },
+                    [&](exception_ptr) { failed = true; });
+            }) |
+            start();
+        // the values before the throw are delivered before the error
+        cout << name << " - " << count << " values then " << (failed ? "error" : "no error") 
+             << (count == 299 && failed ? "" : " - FAILED") << endl;
+    };
+    thrown(copy_if([](int v){ if (v == 300) throw runtime_error("copy_if"); return true; }), "copy_if");
+    thrown(rx::transform([](int v){ if (v == 300) throw runtime_error("transform"); return v; }), "transform");
+}
+
+{
+ cout << "fused and lifted chains of transform" << endl;
+    fusion<1>(first, last * 10000);
+    fusion<2>(first, last * 10000);
+    fusion<4>(first, last * 10000);
+    fusion<8>(first, last * 10000);
+    fusion<16>(first, last * 10000);
+}
+
 #if !RX_SKIP_THREAD
 
 {
@@ -444,8 +651,476 @@ cout << endl;
  cout << sc / s << " values per second\n"; 
 }
 
+{
+ cout << "thread pool" << endl;
+    auto lastofeven = copy_if(even) | 
+        take(100000000) |
+        last_or_default(42);
+
+ auto t0 = high_resolution_clock::now();
+    ints(0, 2) | 
+        observe_on(make_thread_pool<>{}) |
+        transform_merge(make_thread_pool<>{}, [=](int){
+            return ints(first, last * 100) |
+                observe_on(make_thread_pool<>{}) |
+                lastofeven;
+        }) |
+        as_interface<long>() |
+        printto(cout) |
+        start() |
+        join();
+
+ auto t1 = high_resolution_clock::now();
+ auto d = duration_cast<milliseconds>(t1-t0).count() * 1.0;
+ auto sc = ((last * 100) - first) * 3;
+ cout << d / sc << " ms per value\n"; 
+ auto s = d / 1000.0;
+ cout << sc / s << " values per second\n"; 
+}
+
+{
+ cout << "fan-in of 1000 inners on a thread pool" << endl;
+    auto fanin = [=](auto merger, const char* name){
+        size_t count = 0;
+     auto t0 = high_resolution_clock::now();
+        ints(1, 1000) |
+            rx::transform([=](int){
+                return ints(first, last * 10) |
+                    observe_on(make_thread_pool<>{});
+            }) |
+            merger |
+            make_subscriber([&](auto ctx) {
+                return make_observer(ctx.lifetime, [&](int) {
+                    ++count;
+                });
+            }) |
+            start() |
+            join();
+     auto t1 = high_resolution_clock::now();
+     auto s = duration_cast<microseconds>(t1-t0).count() / 1000000.0;
+     cout << name << " - " << count << " values - " << count / s << " values per second\n";
+    };
+    fanin(merge(make_thread_pool<>{}), "merge");
+    fanin(merge_sharded(make_thread_pool<>{}), "merge_sharded");
+}
+
+{
+ cout << "merge_sharded of inners that stop without completing" << endl;
+    atomic<int> count{0};
+    atomic<bool> completed{false};
+    auto merged = ints(1, 10) |
+        rx::transform([](int v){
+            return make_observable([=](auto scrb){
+                return make_starter([=](auto ctx){
+                    auto r = scrb.create(ctx);
+                    r.next(v);
+                    // stopped, not completed
+                    ctx.lifetime.stop();
+                    return ctx.lifetime;
+                });
+            });
+        }) |
+        merge_sharded(make_thread_pool<>{}) |
+        make_subscriber([&](auto ctx) {
+            return make_observer(ctx.lifetime, 
+                [&](int) { ++count; },
+                [&](exception_ptr) {},
+                [&]() { completed = true; });
+        }) |
+        start();
+    for (auto i = 0; i < 5000 && !completed; ++i) {
+        this_thread::sleep_for(1ms);
+    }
+    merged.stop();
+    cout << count << " values - " << (completed ? "completed" : "not completed - FAILED") << endl;
+}
+
+{
+ cout << "async_ints into a slow sink" << endl;
+    auto slow = [=](bool demand, int total, const char* name){
+        size_t count = 0;
+        auto before = rss_kb();
+        auto peak = before;
+     auto t0 = high_resolution_clock::now();
+        // observe_on spills what does not fit in the ring, so without demand 
+        // the backlog is only limited by the speed of the producer
+        async_ints(make_new_thread<>{}, 0, total) |
+            observe_on(make_new_thread<>{}, 1024, observe_on_overflow::spill) |
+            make_subscriber([&, demand](auto ctx) {
+                if (demand) ctx.lifetime.request(64);
+                return make_observer(ctx.lifetime, [&, demand, ctx](int) {
+                    if (++count % 65536 == 0) peak = max(peak, rss_kb());
+                    // slower than the producer
+                    auto until = high_resolution_clock::now() + 3us;
+                    while (high_resolution_clock::now() < until) {}
+                    if (demand) ctx.lifetime.request(1);
+                });
+            }) |
+            start() |
+            join();
+     auto t1 = high_resolution_clock::now();
+     auto s = duration_cast<microseconds>(t1-t0).count() / 1000000.0;
+        auto grew = max(peak, rss_kb()) - before;
+     cout << name << " - " << count << " values - rss grew " << grew << "KB - " << count / s << " values per second\n";
+        return grew;
+    };
+    // the run with demand is first, so that it does not reuse the memory freed by the other
+    // the push run is shorter, its backlog is already clear after a fifth of the values
+    auto requested = slow(true, last * 100000, "request(n)");
+    auto pushed = slow(false, last * 20000, "push");
+    // with demand there are at most 64 values in flight
+    auto bounded = requested < 4096 && requested * 4 < pushed;
+    cout << "request(n) grew " << requested << "KB - push grew " << pushed << "KB - " 
+        << (bounded ? "bounded" : "not bounded - FAILED") << endl;
+}
+
+{
+ cout << "take of async_ints with demand" << endl;
+    auto clamped = [=](size_t initial, size_t each, const char* name){
+        atomic<size_t> produced{0};
+        size_t count = 0;
+        async_ints(make_new_thread<>{}, 0, last * 10000) |
+            rx::transform([&](int v){ ++produced; return v; }) |
+            take(100) |
+            make_subscriber([&, initial, each](auto ctx) {
+                ctx.lifetime.request(initial);
+                return make_observer(ctx.lifetime, [&, each, ctx](int) {
+                    ++count;
+                    if (each > 0) ctx.lifetime.request(each);
+                });
+            }) |
+            start() |
+            join();
+     cout << name << " - " << count << " values - " << produced << " produced for take(100)\n";
+    };
+    clamped(1000000, 0, "request(1000000)");
+    clamped(1, 1, "request(1) per value");
+}
+
+{
+ cout << "transform_merge of 10000 inners on a thread pool" << endl;
+    auto bounded = [=](size_t max_concurrent, const char* name){
+        size_t count = 0;
+        atomic<size_t> subscribed{0};
+        atomic<size_t> peak{0};
+        // counts the inners that are subscribed at the same time
+        auto inflight = make_lifter([&](auto scbr){
+            return make_subscriber([&, scbr](auto ctx){
+                auto now = ++subscribed;
+                auto seen = peak.load();
+                while (seen < now && !peak.compare_exchange_weak(seen, now)) {}
+                auto r = scbr.create(ctx);
+                r.lifetime.insert([&](){ --subscribed; });
+                return r;
+            });
+        });
+     auto t0 = high_resolution_clock::now();
+        ints(1, 10000) |
+            transform_merge(make_thread_pool<>{}, [=](int){
+                return ints(first, last) |
+                    observe_on(make_thread_pool<>{}) |
+                    inflight;
+            }, max_concurrent) |
+            make_subscriber([&](auto ctx) {
+                return make_observer(ctx.lifetime, [&](int) {
+                    ++count;
+                });
+            }) |
+            start() |
+            join();
+     auto t1 = high_resolution_clock::now();
+     auto s = duration_cast<microseconds>(t1-t0).count() / 1000000.0;
+     cout << name << " - " << count << " values - " << peak << " inners at once - " << count / s << " values per second\n";
+    };
+    bounded(numeric_limits<size_t>::max(), "unbounded");
+    bounded(16, "16 at a time");
+}
+
+#endif
+
+#if !RX_SKIP_THREAD
+
+{
+ cout << "observe_on from a thread pinned to the cpus of numa node 0" << endl;
+    auto node = thread_affinity::numa_node(0);
+    auto pinned = [=](thread_affinity affinity, const char* name){
+        long count = 0;
+     auto t0 = high_resolution_clock::now();
+        // observe_on pins its thread near the producer
+        async_ints(make_new_thread<>{affinity}, 0, last * 10000) |
+            observe_on(make_new_thread<>{}) |
+            make_subscriber([&](auto ctx){ 
+                return make_observer(ctx.lifetime, [&](int){ ++count; }); 
+            }) |
+            start() |
+            join();
+     auto t1 = high_resolution_clock::now();
+     auto s = duration_cast<microseconds>(t1-t0).count() / 1000000.0;
+     cout << name << " - " << affinity.cpus.size() << " cpus - " << count / s << " values per second\n";
+    };
+    pinned(node, "pinned");
+    pinned(thread_affinity{}, "any cpu");
+}
+
+{
+ cout << "100 periodic timers at 10kHz on one run_loop" << endl;
+    auto timers = [=](periodic_policy policy, const char* name){
+        auto loop = run_loop<>{subscription{}};
+        auto worker = std::thread([=](){
+            loop.run();
+        });
+        auto c = make_context<steady_clock>(subscription{}, loop.make());
+        atomic<long> count{0};
+        auto ticks = subscription{};
+     auto t0 = high_resolution_clock::now();
+        for (auto i = 0; i < 100; ++i) {
+            auto lifetime = subscription{};
+            ticks.insert(lifetime);
+            defer_periodic(c, c.now(), 100us, make_observer(lifetime, [&](long){
+                ++count;
+            }), policy);
+        }
+        this_thread::sleep_for(1s);
+        ticks.stop();
+        ticks.join();
+     auto t1 = high_resolution_clock::now();
+        c.lifetime.stop();
+        loop.lifetime.stop();
+        worker.join();
+     auto s = duration_cast<microseconds>(t1-t0).count() / 1000000.0;
+     cout << name << " - " << count << " ticks - " << static_cast<long>(s * 100 * 10000) << " due\n";
+    };
+    timers(periodic_policy::catch_up, "catch_up");
+    timers(periodic_policy::skip, "skip");
+}
+
+{
+ cout << "stop of the root seen by the leaf of nested lifetimes" << endl;
+    for (auto depth : {1, 4, 16}) {
+        // the stops that are deferred are run after the poll
+        deque<function<void()>> deferred;
+        vector<subscription> chain{subscription{}};
+        for (auto i = 0; i < depth; ++i) {
+            auto nested = subscription{};
+            chain.back().insert(nested);
+            chain.push_back(nested);
+        }
+        for (auto& lifetime : chain) {
+            lifetime.bind_defer([&](function<void()> target){
+                deferred.push_back(move(target));
+            });
+        }
+        auto root = chain.front();
+        auto leaf = chain.back();
+        chain.clear();
+     auto t0 = high_resolution_clock::now();
+        root.stop();
+        auto requested = leaf.stop_requested();
+     auto t1 = high_resolution_clock::now();
+        auto stopped = leaf.is_stopped();
+        while (!deferred.empty()) {
+            auto target = move(deferred.front());
+            deferred.pop_front();
+            target();
+        }
+     cout << "depth " << depth << " - before the deferred stops ran: stop_requested " << requested << ", is_stopped " << stopped 
+          << " - after: is_stopped " << leaf.is_stopped() << " - " << duration_cast<nanoseconds>(t1-t0).count() << "ns to stop the root\n";
+    }
+    {
+        // an erased lifetime does not see the stops of its former parent
+        subscription parent;
+        subscription nested;
+        parent.insert(nested);
+        parent.erase(nested);
+        parent.stop();
+        auto requested = nested.stop_requested();
+        cout << "erased - stop_requested " << requested << (requested ? " - FAILED" : "") << endl;
+        nested.stop();
+    }
+}
+
+{
+ cout << "join waits for the nested lifetimes that the stop swept" << endl;
+    subscription parent;
+    subscription swept;
+    subscription erased;
+    parent.insert(swept);
+    parent.insert(erased);
+    // a lifetime erased before the stop is not waited for
+    parent.erase(erased);
+    atomic<bool> finished{false};
+    swept.insert([&](){ finished = true; });
+    std::thread worker;
+    // the stop of swept finishes later, on another thread
+    swept.bind_defer([&](function<void()> target){
+        worker = std::thread([target](){
+            this_thread::sleep_for(10ms);
+            target();
+        });
+    });
+    parent.stop();
+    parent.join();
+    auto waited = finished.load();
+    auto stopped = erased.is_stopped();
+    worker.join();
+    erased.stop();
+    cout << "swept " << (waited ? "finished" : "not finished - FAILED") 
+         << " - erased " << (stopped ? "stopped - FAILED" : "not waited for") << endl;
+}
+
+{
+ cout << "deferred stops keep their order with the items on a run_loop" << endl;
+    auto loop = run_loop<>{subscription{}};
+    auto make = loop.make();
+    mutex lock;
+    vector<string> order;
+    auto record = [&](string what){
+        unique_lock<mutex> guard(lock);
+        order.push_back(what);
+    };
+    auto first = subscription{};
+    auto second = subscription{};
+    auto c1 = make_context<steady_clock>(first, make);
+    auto c2 = make_context<steady_clock>(second, make);
+    first.insert([&](){ record("first stop"); });
+    second.insert([&](){ record("second stop"); });
+    // queued before the loop runs: a sweep, an item and a stop that must not join the sweep
+    first.stop();
+    defer(c2, make_observer(subscription{}, [&](auto& ){ record("item"); }));
+    second.stop();
+    auto worker = std::thread([=](){
+        loop.run();
+    });
+    for (auto i = 0; i < 1000; ++i) {
+        {
+            unique_lock<mutex> guard(lock);
+            if (order.size() == 3) break;
+        }
+        this_thread::sleep_for(1ms);
+    }
+    loop.lifetime.stop();
+    worker.join();
+    auto expected = vector<string>{"first stop", "item", "second stop"};
+    for (auto& what : order) cout << what << " - ";
+    cout << (order == expected ? "in order" : "FAILED") << endl;
+}
+
+{
+#if RX_LOCKFREE_SUBSCRIPTION
+ cout << "subscription insert/stop (lock-free)" << endl;
+#else
+ cout << "subscription insert/stop (mutex)" << endl;
+#endif
+ auto threads = std::max(2u, std::thread::hardware_concurrency());
+ auto t0 = high_resolution_clock::now();
+    auto parent = subscription{};
+    vector<std::thread> workers;
+    for (auto t = 0u; t < threads; ++t) {
+        workers.emplace_back([=](){
+            for(auto i = first; i < last * 1000; ++i) {
+                auto nested = subscription{};
+                parent.insert(nested);
+                nested.insert([](){});
+                nested.stop();
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    parent.stop();
+    parent.join();
+
+ auto t1 = high_resolution_clock::now();
+ auto d = duration_cast<milliseconds>(t1-t0).count() * 1.0;
+ auto sc = (last * 1000 - first) * threads;
+ cout << d / sc << " ms per insert/stop\n"; 
+ auto s = d / 1000.0;
+ cout << sc / s << " insert/stop per second\n"; 
+}
+
+{
+ cout << "run_loop context teardown" << endl;
+    auto loop = run_loop<>{subscription{}};
+    auto worker = std::thread([=](){
+        loop.run();
+    });
+    auto make = loop.make();
+    auto count = last * 1000 - first;
+    // a binary tree of contexts on strands of the same loop
+    vector<subscription> lifetimes{subscription{}};
+    for (auto i = 1; i < count; ++i) {
+        auto lifetime = subscription{};
+        lifetimes[(i - 1) / 2].insert(lifetime);
+        make_context<steady_clock>(lifetime, make);
+        lifetimes.push_back(lifetime);
+    }
+    auto root = lifetimes.front();
+    lifetimes.clear();
+
+ auto t0 = high_resolution_clock::now();
+
+    root.stop();
+    root.join();
+
+ auto t1 = high_resolution_clock::now();
+    loop.lifetime.stop();
+    worker.join();
+
+ auto d = duration_cast<milliseconds>(t1-t0).count() * 1.0;
+ auto sc = count;
+ cout << d / sc << " ms per context\n";
+ auto s = d / 1000.0;
+ cout << sc / s << " contexts per second\n";
+}
+
 #endif
 
+{
+ // keeps last * 1000 timers pending over the next second
+ // and replaces the earliest timer with a later one
+ auto timers = [=](auto policy, const char* name) {
+    using loop_type = run_loop<steady_clock, exception_ptr, decltype(policy)>;
+    using item_type = typename loop_type::item_type;
+    using queue_type = typename loop_type::queue_type;
+
+ cout << "run_loop timers (" << name << ")" << endl;
+    typename loop_type::observer_type out = make_observer(subscription{}, [](auto){});
+    auto deferred = make_unique<queue_type>();
+    mt19937 source(42);
+    uniform_int_distribution<int> spread(1, 1000000);
+    auto origin = steady_clock::now();
+    auto pending = last * 1000 - first;
+    for (auto i = 0; i < pending; ++i) {
+        deferred->push(item_type{origin + microseconds(spread(source)), out});
+    }
+
+ auto t0 = high_resolution_clock::now();
+    auto expired = origin;
+    for (auto i = 0; i < pending * 10; ++i) {
+        auto next = deferred->take();
+        if (duration_cast<milliseconds>(next.when - expired).count() < 0) {
+            cout << "out of order" << endl;
+        }
+        expired = next.when;
+        next.when += microseconds(spread(source));
+        deferred->push(move(next));
+    }
+    while (!deferred->empty()) {
+        deferred->pop();
+    }
+
+ auto t1 = high_resolution_clock::now();
+ auto d = duration_cast<milliseconds>(t1-t0).count() * 1.0;
+ auto sc = pending * 10;
+ cout << d / sc << " ms per timer\n";
+ auto s = d / 1000.0;
+ cout << sc / s << " timers per second\n";
+ };
+    timers(observe_at_heap{}, "heap");
+    timers(observe_at_timer_wheel<>{}, "timer wheel");
+}
+
 {
  cout << "for" << endl;
  auto t0 = high_resolution_clock::now();
@@ -555,6 +1230,35 @@ cout << endl;
  auto s = d / 1000.0;
  cout << sc / s << " subscriptions per second\n"; 
 }
+
+{
+ cout << "transform_merge thread_pool" << endl;
+ auto t0 = high_resolution_clock::now();
+
+    ints(first, last) | 
+        transform_merge(make_thread_pool<>{}, 
+            [=](int){
+                return ints(0, 0) |
+                    transform([](int i) {
+                        return to_string(i);
+                    }) |
+                    transform([](const string& s) {
+                        int i = '0' - s[0];
+                        return i;
+                    });
+            }) |
+        as_interface<int>() |
+        make_subscriber() |
+        start() |
+        join();
+
+ auto t1 = high_resolution_clock::now();
+ auto d = duration_cast<milliseconds>(t1-t0).count() * 1.0;
+ auto sc = last - first;
+ cout << d / sc << " ms per subscription\n"; 
+ auto s = d / 1000.0;
+ cout << sc / s << " subscriptions per second\n"; 
+}
 this_thread::sleep_for(1s);
 cout << endl;
 
@@ -2,19 +2,24 @@
 
 namespace rx {
 
+namespace detail {
+
+template<class Pred>
+struct copy_if_step {
+    Pred pred;
+    template<class Emit, class V>
+    void operator()(const Emit& emit, V&& v) const {
+        if (pred(v)) emit(std::forward<V>(v));
+    }
+    template<class V>
+    decay_t<V> result(V&& v) const;
+};
+
+}
+
 const auto copy_if = [](auto pred){
-    info("new copy_if");
-    return make_lifter([=](auto scbr){
-        info("copy_if bound to subscriber");
-        return make_subscriber([=](auto ctx){
-            info("copy_if bound to context lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(ctx.lifetime.store.get())));
-            auto r = scbr.create(ctx);
-            info("copy_if observer lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(r.lifetime.store.get())));
-            return make_observer(r, r.lifetime, [=](auto& r, auto v){
-                if (pred(v)) r.next(v);
-            });
-        });
-    });
+    RX_TRACE("new copy_if");
+    return make_fused_lifter(detail::copy_if_step<decltype(pred)>{pred});
 };
 
 }
\ No newline at end of file
@@ -3,19 +3,21 @@
 namespace rx {
 
 const auto delay = [](auto makeStrand, auto delay){
-    info("new delay");
+    RX_TRACE("new delay");
     return make_lifter([=](auto scbr){
-        info("delay bound to subscriber");
+        RX_TRACE("delay bound to subscriber");
         return make_subscriber([=](auto ctx){
-            info("delay bound to context");
+            RX_TRACE("delay bound to context");
             subscription lifetime;
             ctx.lifetime.insert(lifetime);
             auto outcontext = copy_context(ctx.lifetime, makeStrand, ctx);
             auto r = scbr.create(outcontext);
             return make_observer(r, lifetime, 
                 [=](auto& r, auto v){
+                    // copies of the deferred observer share the value, it is moved out once
+                    auto value = make_shared<decltype(v)>(move(v));
                     auto next = make_observer(r, subscription{}, [=](auto& r, auto& ){
-                        r.next(v);
+                        r.next(move(*value));
                     }, detail::pass{}, detail::skip{});
                     defer_after(outcontext, delay, next);
                 },
@@ -3,14 +3,14 @@
 namespace rx {
 
 const auto finally = [](auto f){
-    info("new finally");
+    RX_TRACE("new finally");
     return make_lifter([=](auto scbr){
-        info("finally bound to subscriber");
+        RX_TRACE("finally bound to subscriber");
         return make_subscriber([=](auto ctx){
-            info("finally bound to context lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(ctx.lifetime.store.get())));
+            RX_TRACE(ctx.lifetime.store.get(), "finally bound to context lifetime");
             auto r = scbr.create(ctx);
             r.lifetime.insert(f);
-            info("finally observer lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(r.lifetime.store.get())));
+            RX_TRACE(r.lifetime.store.get(), "finally observer lifetime");
             return make_observer(r, r.lifetime);
         });
     });
@@ -3,21 +3,31 @@
 namespace rx {
 
 const auto last_or_default = [](auto def){
-        info("new last_or_default");
+        RX_TRACE("new last_or_default");
     return make_lifter([=](auto scbr){
-        info("last_or_default bound to subscriber");
+        RX_TRACE("last_or_default bound to subscriber");
         return make_subscriber([=](auto ctx){
-            info("last_or_default bound to context lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(ctx.lifetime.store.get())));
+            RX_TRACE(ctx.lifetime.store.get(), "last_or_default bound to context lifetime");
             auto r = scbr.create(ctx);
             auto last = make_state<std::decay_t<decltype(def)>>(ctx.lifetime, def);
-            info("last_or_default observer lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(r.lifetime.store.get())));
+            // the values are not passed on, so their credit is returned to the producer
+            auto refund = detail::refund{r.lifetime.demand()};
+            RX_TRACE(r.lifetime.store.get(), "last_or_default observer lifetime");
             return make_observer(r, r.lifetime,
-                [last](auto& , auto v){
-                    last.get() = v;
-                },
+                detail::make_batched(
+                    [last, refund](auto& , auto&& v){
+                        last.get() = std::forward<decltype(v)>(v);
+                        refund(1);
+                    },
+                    [last, refund](auto& , auto values){
+                        if (values.size() > 0) {
+                            last.get() = values[values.size() - 1];
+                            refund(values.size());
+                        }
+                    }),
                 detail::skip{},
                 [last](auto& r){
-                    r.next(last.get());
+                    r.next(move(last.get()));
                     r.complete();
                 });
         });
@@ -2,35 +2,269 @@
 
 namespace rx {
 
+/// what observe_on does with a value that does not fit in its ring
+enum class observe_on_overflow {
+    /// the value is kept in an unbounded list. values stay in order and the producer does not wait.
+    spill,
+    /// the producer waits until there is space. the destination strand must not run on the producer's thread.
+    block
+};
+
+namespace detail {
+
+///
+/// \brief the queue between the producer and the destination strand of observe_on.
+/// values are written to a ring that is made for the type of the first value.
+/// one deferred drain delivers every queued value. a value that does not fit,
+/// or that has another type, is spilled as a closure and every later value is
+/// spilled too until the drain has emptied the spill, so the order is kept.
+///
+/// when the destination has opted in to demand, the drain takes a unit of the 
+/// destination credit for each value from the ring and parks when there is none.
+/// the producer is given its own demand that is refilled by the number of values 
+/// each drain delivered, so at most capacity values are queued.
+///
+struct observe_on_state
+{
+    observe_on_state(size_t capacity, observe_on_overflow policy)
+        : capacity(capacity)
+        , policy(policy)
+        , type(nullptr)
+        , spilling(false)
+        , terminated(false)
+        , finished(false)
+        , scheduled(false)
+        , starved(false) {
+    }
+    const size_t capacity;
+    const observe_on_overflow policy;
+
+    const type_info* type;
+    shared_ptr<void> ring;
+    /// delivers up to n values from the ring. \returns the number delivered.
+    function<size_t(size_t)> drain_ring;
+    function<bool()> ring_empty;
+
+    mutex lock;
+    deque<function<void()>> spill;
+    atomic<bool> spilling;
+
+    function<void()> terminal;
+    atomic<bool> terminated;
+    bool finished;
+
+    /// true while a drain is deferred or running
+    atomic<bool> scheduled;
+
+    /// the demand of the destination and of the producer. empty unless the destination opted in
+    shared_ptr<demand> down;
+    shared_ptr<demand> up;
+    /// set by drain_ring when it stopped for lack of credit
+    bool starved;
+    /// schedules a drain. cleared when the producer lifetime stops
+    function<void()> wake;
+
+    bool pending() const {
+        return (ring_empty && !ring_empty()) || spilling || terminated;
+    }
+};
+
+}
+
 template<class MakeStrand>
-auto observe_on(MakeStrand makeStrand){
-    info("new observe_on");
+auto observe_on(MakeStrand makeStrand, size_t capacity = 1024, observe_on_overflow policy = observe_on_overflow::spill){
+    RX_TRACE("new observe_on");
     return make_lifter([=](auto scbr){
-        info("observe_on bound to subscriber");
+        RX_TRACE("observe_on bound to subscriber");
         return make_subscriber([=](auto ctx){
-            info("observe_on bound to context");
+            RX_TRACE("observe_on bound to context");
             subscription lifetime;
             ctx.lifetime.insert(lifetime);
-            auto outcontext = copy_context(ctx.lifetime, makeStrand, ctx);
+            // a new thread is pinned to the cpus of the producer, when they are known
+            auto outcontext = copy_context(ctx.lifetime, detail::colocate(makeStrand, ctx.m, 0), ctx);
             auto r = scbr.create(outcontext);
+            auto st = make_state<detail::observe_on_state>(lifetime, capacity, policy);
+            if (auto down = r.lifetime.demand()) {
+                auto& s = st.get();
+                s.down = down;
+                s.up = make_shared<detail::demand>();
+                lifetime.bind_demand(s.up);
+                s.up->request(capacity);
+            }
+            // spilled values share one copy of the destination
+            auto spillto = make_shared<decltype(r)>(r);
+
+            auto drain = [=](auto& , auto& self){
+                auto& s = st.get();
+                size_t delivered = 0;
+                for (;;) {
+                    if (s.drain_ring) {
+                        auto drained = s.drain_ring(s.capacity - delivered);
+                        delivered += drained;
+                        if (s.up && drained > 0) {
+                            s.up->request(drained);
+                        }
+                    }
+                    if (s.starved) {
+                        s.starved = false;
+                        function<void()> wake;
+                        {
+                            unique_lock<mutex> guard(s.lock);
+                            wake = s.wake;
+                        }
+                        s.scheduled = false;
+                        atomic_thread_fence(memory_order_seq_cst);
+                        if (!wake || s.down->park(move(wake)) || s.scheduled.exchange(true)) {
+                            return;
+                        }
+                        // credit arrived before the drain parked
+                        continue;
+                    }
+                    if (delivered >= s.capacity) {
+                        // let other work on the strand run
+                        self(outcontext.now());
+                        return;
+                    }
+                    deque<function<void()>> spilled;
+                    {
+                        unique_lock<mutex> guard(s.lock);
+                        swap(spilled, s.spill);
+                        if (spilled.empty()) {
+                            s.spilling = false;
+                        }
+                    }
+                    if (!spilled.empty()) {
+                        // the values in the ring were pushed before the first spilled value
+                        size_t drained = 0;
+                        while (s.drain_ring && !s.starved) {
+                            auto count = s.drain_ring(s.capacity);
+                            if (count == 0) break;
+                            drained += count;
+                        }
+                        if (s.up && drained > 0) {
+                            s.up->request(drained);
+                        }
+                        if (s.starved) {
+                            // the spilled values wait for the ring
+                            unique_lock<mutex> guard(s.lock);
+                            move(s.spill.begin(), s.spill.end(), back_inserter(spilled));
+                            swap(spilled, s.spill);
+                            s.spilling = true;
+                            continue;
+                        }
+                        for (auto& next : spilled) {
+                            next();
+                        }
+                        delivered += spilled.size();
+                        continue;
+                    }
+                    if (s.terminated.load(memory_order_acquire)) {
+                        if (!s.finished) {
+                            s.finished = true;
+                            s.terminal();
+                        }
+                        return;
+                    }
+                    s.scheduled = false;
+                    atomic_thread_fence(memory_order_seq_cst);
+                    if (!s.pending() || s.scheduled.exchange(true)) {
+                        return;
+                    }
+                }
+            };
+
+            auto schedule = [=](){
+                auto& s = st.get();
+                atomic_thread_fence(memory_order_seq_cst);
+                if (!s.scheduled.exchange(true)) {
+                    defer(outcontext, make_observer(r, subscription{}, drain, detail::pass{}, detail::skip{}));
+                }
+            };
+
+            if (st.get().down) {
+                {
+                    auto& s = st.get();
+                    unique_lock<mutex> guard(s.lock);
+                    s.wake = schedule;
+                }
+                // wake refers to the state
+                lifetime.insert([st](){
+                    auto& s = st.get();
+                    s.up->close();
+                    unique_lock<mutex> guard(s.lock);
+                    s.wake = nullptr;
+                });
+            }
+
             return make_observer(r, lifetime, 
                 [=](auto& r, auto v){
-                    auto next = make_observer(r, subscription{}, [=](auto& r, auto& ){
-                        r.next(v);
-                    }, detail::pass{}, detail::skip{});
-                    defer(outcontext, next);
+                    using value_type = decltype(v);
+                    auto& s = st.get();
+                    if (!s.type) {
+                        auto ring = make_shared<detail::mpsc_ring<value_type>>(s.capacity);
+                        s.type = &typeid(value_type);
+                        s.ring = ring;
+                        auto ps = addressof(s);
+                        s.drain_ring = [ring, r, ps](size_t n){
+                            size_t count = 0;
+                            while (count < n && !ring->empty()) {
+                                if (ps->down && !ps->down->try_take()) {
+                                    ps->starved = true;
+                                    break;
+                                }
+                                ring->consume([&](value_type&& v){ r.next(move(v)); });
+                                ++count;
+                            }
+                            return count;
+                        };
+                        s.ring_empty = [ring](){
+                            return ring->empty();
+                        };
+                    }
+                    if (!s.spilling && *s.type == typeid(value_type)) {
+                        auto& ring = *static_cast<detail::mpsc_ring<value_type>*>(s.ring.get());
+                        if (ring.try_push(move(v))) {
+                            schedule();
+                            return;
+                        }
+                        if (s.policy == observe_on_overflow::block) {
+                            RX_TRACE(addressof(s), "observe_on: ring full, wait");
+                            schedule();
+                            while (!ring.try_push(move(v))) {
+                                if (r.lifetime.stop_requested()) {
+                                    return;
+                                }
+                                this_thread::yield();
+                            }
+                            schedule();
+                            return;
+                        }
+                    }
+                    RX_TRACE(addressof(s), "observe_on: spill");
+                    {
+                        unique_lock<mutex> guard(s.lock);
+                        s.spilling = true;
+                        s.spill.push_back([spillto, v = move(v)]() mutable {
+                            spillto->next(move(v));
+                        });
+                    }
+                    schedule();
                 },
                 [=](auto& r, auto e){
-                    auto error = make_observer(r, subscription{}, [=](auto& r, auto& ){
+                    auto& s = st.get();
+                    s.terminal = [r, e](){
                         r.error(e);
-                    }, detail::pass{}, detail::skip{});
-                    defer(outcontext, error);
+                    };
+                    s.terminated.store(true, memory_order_release);
+                    schedule();
                 },
                 [=](auto& r){
-                    auto complete = make_observer(r, subscription{}, [=](auto& r, auto& ){
+                    auto& s = st.get();
+                    s.terminal = [r](){
                         r.complete();
-                    }, detail::pass{}, detail::skip{});
-                    defer(outcontext, complete);
+                    };
+                    s.terminated.store(true, memory_order_release);
+                    schedule();
                 });
         });
     });
@@ -38,13 +272,13 @@ auto observe_on(MakeStrand makeStrand){
 
 #if !RX_SLOW
 template<class Clock>
-auto observe_on(const detail::make_immediate<Clock>&){
-    info("new observe_on");
+auto observe_on(const detail::make_immediate<Clock>&, size_t = 0, observe_on_overflow = observe_on_overflow::spill){
+    RX_TRACE("new observe_on");
     return make_lifter([=](auto scbr){
-        info("observe_on bound to subscriber");
+        RX_TRACE("observe_on bound to subscriber");
         return scbr;
     });
 }
 #endif
 
-}
\ No newline at end of file
+}
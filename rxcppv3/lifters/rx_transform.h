@@ -2,19 +2,25 @@
 
 namespace rx {
 
+namespace detail {
+
+/// f is called with an lvalue when it does not accept an rvalue (eg. f takes T&)
+template<class F>
+struct transform_step {
+    F f;
+    template<class Emit, class V>
+    void operator()(const Emit& emit, V&& v) const {
+        emit(invoke_forwarded(f, std::forward<V>(v)));
+    }
+    template<class V>
+    auto result(V&& v) const -> decltype(invoke_forwarded(f, std::forward<V>(v)));
+};
+
+}
+
 const auto transform = [](auto f){
-    info("new transform");
-    return make_lifter([=](auto scbr){
-        info("transform bound to subscriber");
-        return make_subscriber([=](auto ctx){
-            info("transform bound to context lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(ctx.lifetime.store.get())));
-            auto r = scbr.create(ctx);
-            info("transform observer lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(r.lifetime.store.get())));
-            return make_observer(r, r.lifetime, [=](auto& r, auto& v){
-                r.next(f(v));
-            });
-        });
-    });
+    RX_TRACE("new transform");
+    return make_fused_lifter(detail::transform_step<decltype(f)>{f});
 };
 
 }
\ No newline at end of file
@@ -2,18 +2,27 @@
 
 namespace rx {
 
-const auto intervals = [](auto makeStrand, auto initial, auto period){
-    info("new intervals");
+const auto intervals = [](auto makeStrand, auto initial, auto period, periodic_policy policy = periodic_policy::catch_up){
+    RX_TRACE("new intervals");
     return make_observable([=](auto scrb){
-        info("intervals bound to subscriber");
+        RX_TRACE("intervals bound to subscriber");
         return make_starter([=](auto ctx) {
-            info("intervals bound to context");
+            RX_TRACE("intervals bound to context");
             subscription lifetime;
             ctx.lifetime.insert(lifetime);
             auto intervalcontext = copy_context(lifetime, makeStrand, ctx);
             auto r = scrb.create(ctx);
-            info("intervals started");
-            defer_periodic(intervalcontext, initial, period, r);
+            RX_TRACE("intervals started");
+            auto credit = r.lifetime.demand();
+            if (credit) {
+                // the time does not wait for the consumer, a tick without credit is dropped
+                defer_periodic(intervalcontext, initial, period, make_observer(r, r.lifetime,
+                    [credit](auto& r, auto&& v){
+                        if (credit->try_take()) r.next(std::forward<decltype(v)>(v));
+                    }), policy);
+                return ctx.lifetime;
+            }
+            defer_periodic(intervalcontext, initial, period, r, policy);
             return ctx.lifetime;
         });
     });
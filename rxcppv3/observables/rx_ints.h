@@ -2,17 +2,30 @@
 
 namespace rx {
 
+/// \brief the values [first, last] in batches, on the thread that starts it.
+/// ints ignores demand: the loop does not return until it is done or stopped,
+/// so there is no later point at which a request could resume it.
+/// async_ints honors demand.
 const auto ints = [](auto first, auto last){
-    info("new ints");
+    RX_TRACE("new ints");
     return make_observable([=](auto scrb){
-        info("ints bound to subscriber");
+        RX_TRACE("ints bound to subscriber");
         return make_starter([=](auto ctx) {
-            info("ints bound to context");
+            RX_TRACE("ints bound to context");
             auto r = scrb.create(ctx);
-            info("ints started");
-            for(auto i = first;!r.lifetime.is_stopped(); ++i){
-                r.next(i);
-                if (i == last) break;
+            RX_TRACE("ints started");
+            // the values are passed in batches, [first, last] inclusive
+            using value_type = decltype(first);
+            value_type batch[detail::batch_size];
+            bool done = false;
+            for(auto i = first;!done && !r.lifetime.stop_requested();){
+                size_t count = 0;
+                while (count < detail::batch_size) {
+                    batch[count++] = i;
+                    if (i == last) { done = true; break; }
+                    ++i;
+                }
+                r.next_batch(span<const value_type>(batch, count));
             }
             r.complete();
             return ctx.lifetime;
@@ -20,30 +33,62 @@ const auto ints = [](auto first, auto last){
     });
 };
 
+namespace detail {
+
+///
+/// \brief the deferred loop of async_ints. 
+/// when the consumer has opted in to demand, the loop parks while there is 
+/// no credit and the next request defers a new loop.
+///
+template<class Context, class T>
+struct async_ints_loop
+{
+    Context outcontext;
+    subscription lifetime;
+    state<T> current;
+    T last;
+    shared_ptr<demand> credit;
+
+    template<class Out>
+    void start(const Out& r) const {
+        subscription run;
+        lifetime.insert(run);
+        defer(outcontext, make_observer(r, run, *this, pass{}, skip{}));
+    }
+
+    template<class Out, class Self>
+    void operator()(const Out& r, Self& self) const {
+        if (lifetime.stop_requested()) return;
+        auto loop = *this;
+        if (!take_or_park(credit, [loop, r](){ loop.start(r); })) {
+            return;
+        }
+        auto& s = current.get();
+        r.next(s);
+        if (++s == last) {
+            r.complete();
+        }
+        self(outcontext.now());
+    }
+};
+
+}
+
 const auto async_ints = [](auto makeStrand, auto first, auto last){
-    info("new async_ints");
+    RX_TRACE("new async_ints");
     return make_observable([=](auto scrb){
-        info("async_ints bound to subscriber");
+        RX_TRACE("async_ints bound to subscriber");
         return make_starter([=](auto ctx) {
-            info("async_ints bound to context");
+            RX_TRACE("async_ints bound to context");
             subscription lifetime;
             ctx.lifetime.insert(lifetime);
             auto outcontext = copy_context(ctx.lifetime, makeStrand, ctx);
             auto r = scrb.create(outcontext);
             auto state = make_state<decltype(first)>(ctx.lifetime, first);
-            auto lifted = make_observer(
-                r,
-                lifetime, 
-                [=](const auto& r, auto& self) mutable {
-                    auto& s = state.get();
-                    r.next(s);
-                    if (++s == last) {
-                        r.complete();
-                    }
-                    self(outcontext.now());
-                }, detail::pass{}, detail::skip{});
-            info("async_ints started");
-            defer(outcontext, lifted);
+            auto loop = detail::async_ints_loop<decltype(outcontext), decltype(first)>{
+                outcontext, lifetime, state, last, r.lifetime.demand()};
+            RX_TRACE("async_ints started");
+            loop.start(r);
             return ctx.lifetime;
         });
     });
@@ -15,6 +15,14 @@
 #include <sstream>
 #include <future>
 #include <queue>
+#include <memory>
+#include <atomic>
+#include <fstream>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace rx {
 
@@ -26,12 +34,46 @@ using std::decay_t;
 
 #include "rx_util.h"
 
+/// RX_TRACE() is compiled out unless RX_INFO is set.
+/// RX_INFO=1 traces text through info(), RX_INFO=2 records binary events
+///
+#include "rx_trace.h"
+
+/// an intrusive lock-free stack used by the nesting graph of a subscription
+/// when RX_LOCKFREE_SUBSCRIPTION is set
+///
+#include "rx_atomic_stack.h"
+
+/// a bump allocator that holds the state made for a subscription
+///
+#include "rx_state_arena.h"
+
+/// an inline type-erased holder used by the interface types so that 
+/// small observers, strands and contexts do not allocate
+///
+#include "rx_inline_interface.h"
+
+/// a bounded lock-free queue with many producers and one consumer used by observe_on
+///
+#include "rx_mpsc_ring.h"
+
+/// an unbounded lock-free queue with one producer and one consumer used by merge_sharded
+///
+#include "rx_spsc_queue.h"
+
+/// the credit that a consumer requests from the producers of a lifetime
+///
+#include "rx_demand.h"
+
 /// a subscription represents a managed asynchronous scope
 ///
 /// similar to shared_ptr a subscription provides allocations that are scoped to its lifetime
 /// nested scopes are supported by insert(subscription)/erase(subscription)
 /// the async scope can be cancelled using stop(), the stop can be handled using insert(void())
-/// the async scope can be joined by join()
+/// producers poll stop_requested(), which sees the stop() of an enclosing scope before the sweep
+/// the async scope can be joined by join() or, without blocking, by on_joined(void())
+/// a consumer can opt in to demand with request(n), after which the producers 
+/// that honor demand send at most the requested number of values
 ///
 #include "rx_subscription.h"
 
@@ -114,13 +156,16 @@ using std::decay_t;
 
 #include "adaptors/rx_take.h"
 #include "adaptors/rx_merge.h"
+#include "adaptors/rx_merge_sharded.h"
 #include "adaptors/rx_transform_merge.h"
 
 #include "subscribers/rx_printto.h"
 
 #include "schedulers/rx_observe_at_queue.h"
+#include "schedulers/rx_observe_at_wheel.h"
 #include "schedulers/rx_run_loop.h"
 #include "schedulers/rx_new_thread.h"
+#include "schedulers/rx_thread_pool.h"
 
 namespace rx {
 
@@ -132,6 +177,7 @@ struct state;
 struct subscription
 {
     bool is_stopped();
+    bool stop_requested();
     void stop();
 
     void insert(const subscription& s);
@@ -139,13 +185,19 @@ struct subscription
 
     void insert(function<void()> stopper);
 
+    void reserve(size_t size);
+
     template<class Payload, class... ArgN>
     state<Payload> make_state(ArgN... argn);
     template<class Payload>
     state<Payload> copy_state(const state<Payload>&);
 
     void bind_defer(function<void(function<void()>)> d);
+
+    void request(size_t n);
     
+    void on_joined(function<void()> f);
+    future<void> joined();
     void join();
 };
 
@@ -158,6 +210,8 @@ struct state {
 struct observer {
     template<class T>
     void next(T);
+    template<class T>
+    void next_batch(span<T>);
     template<class E>
     void error(E);
     void complete();
@@ -215,7 +269,7 @@ void defer_at(strand<Clock>, typename Clock::time_point, observer);
 template<class Clock>
 void defer_after(strand<Clock>, typename Clock::duration, observer);
 template<class Clock>
-void defer_periodic(strand<Clock>, typename Clock::time_point, typename Clock::duration, observer);
+void defer_periodic(strand<Clock>, typename Clock::time_point, typename Clock::duration, observer, periodic_policy = periodic_policy::catch_up);
 
 template<class Payload, class Clock>
 void defer(context<Payload, Clock>, observer);
@@ -224,7 +278,7 @@ void defer_at(context<Payload, Clock>, typename Clock::time_point, observer);
 template<class Payload, class Clock>
 void defer_after(context<Payload, Clock>, typename Clock::duration, observer);
 template<class Payload, class Clock>
-void defer_periodic(context<Payload, Clock>, typename Clock::time_point, typename Clock::duration, observer);
+void defer_periodic(context<Payload, Clock>, typename Clock::time_point, typename Clock::duration, observer, periodic_policy = periodic_policy::catch_up);
 
 }
 
@@ -0,0 +1,78 @@
+#pragma once
+
+namespace rx {
+
+namespace detail {
+
+///
+/// \brief An intrusive lock-free stack of Node (Node must have a `Node* next` member).
+/// push() prepends with a single CAS. take() and close() remove every node
+/// at once, so there is no ABA hazard. After close() the head holds a
+/// sentinel and every later push() fails.
+///
+template<class Node>
+struct atomic_stack
+{
+    atomic_stack() : head(nullptr) {}
+    atomic_stack(const atomic_stack&) = delete;
+    atomic_stack& operator=(const atomic_stack&) = delete;
+
+    static Node* closed() {
+        static char sentinel;
+        return reinterpret_cast<Node*>(&sentinel);
+    }
+
+    bool is_closed() const {
+        return head.load(memory_order_acquire) == closed();
+    }
+
+    /// \returns the first node or nullptr. nodes are not removed.
+    Node* peek() const {
+        auto h = head.load(memory_order_acquire);
+        return h == closed() ? nullptr : h;
+    }
+
+    /// \returns false if the stack was closed. the caller still owns n.
+    bool push(Node* n) {
+        return splice(n, n);
+    }
+
+    /// \brief prepends the chain [first, last]
+    /// \returns false if the stack was closed. the caller still owns the chain.
+    bool splice(Node* first, Node* last) {
+        auto h = head.load(memory_order_acquire);
+        do {
+            if (h == closed()) {
+                return false;
+            }
+            last->next = h;
+        } while (!head.compare_exchange_weak(h, first, memory_order_release, memory_order_acquire));
+        return true;
+    }
+
+    /// \brief removes all the nodes and leaves the stack open.
+    /// \returns the chain of nodes in LIFO order or nullptr.
+    Node* take() {
+        auto h = head.load(memory_order_acquire);
+        do {
+            if (h == closed() || h == nullptr) {
+                return nullptr;
+            }
+        } while (!head.compare_exchange_weak(h, nullptr, memory_order_acq_rel, memory_order_acquire));
+        return h;
+    }
+
+    /// \brief removes all the nodes and closes the stack.
+    /// \returns the chain of nodes in LIFO order or nullptr.
+    Node* close() {
+        auto h = head.exchange(closed(), memory_order_acq_rel);
+        return h == closed() ? nullptr : h;
+    }
+
+private:
+    atomic<Node*> head;
+};
+
+}
+
+}
@@ -29,7 +29,7 @@ namespace detail {
             return d.now();
         }
         virtual void defer_at(time_point_t<clock_type> at, observer_interface<re_defer_at_t<C>, E> out) const {
-            d.defer_at(at, out);
+            d.defer_at(at, move(out));
         }
     };
     
@@ -57,18 +57,19 @@ struct context<interface<C, E>> {
     using payload_type = void;
     using clock_type = decay_t<C>;
     using errorvalue_type = decay_t<E>;
+    using abstract_type = detail::abstract_context<clock_type, errorvalue_type>;
     context(const context& o) = default;
     context(context&& o) = default;
     context(const context<void, void, clock_type>& o)
         : lifetime(o.lifetime)
-        , d(make_shared<detail::basic_context<C, E, void>>(o))
+        , d(detail::make_inline_interface<abstract_type, detail::basic_context<C, E, void>>(o))
         , m([m = o.m](subscription lifetime){
             return m(lifetime);
         }) {
     }
     context(context<void, void, clock_type>&& o)
         : lifetime(o.lifetime)
-        , d(make_shared<detail::basic_context<C, E, void>>(o))
+        , d(detail::make_inline_interface<abstract_type, detail::basic_context<C, E, void>>(o))
         , m([m = o.m](subscription lifetime){
             return m(lifetime);
         }) {
@@ -76,7 +77,7 @@ struct context<interface<C, E>> {
     template<class... CN>
     context(const context<CN...>& o)
         : lifetime(o.lifetime)
-        , d(make_shared<detail::basic_context<C, E, decay_t<decltype(o.m)>>>(o))
+        , d(detail::make_inline_interface<abstract_type, detail::basic_context<C, E, decay_t<decltype(o.m)>>>(o))
         , m([m = o.m](subscription lifetime){
             return m(lifetime);
         }) {
@@ -84,20 +85,20 @@ struct context<interface<C, E>> {
     template<class... CN>
     context(context<CN...>&& o)
         : lifetime(o.lifetime)
-        , d(make_shared<detail::basic_context<C, E, decay_t<decltype(o.m)>>>(o))
+        , d(detail::make_inline_interface<abstract_type, detail::basic_context<C, E, decay_t<decltype(o.m)>>>(o))
         , m([m = o.m](subscription lifetime){
             return m(lifetime);
         }) {
     }
 
     subscription lifetime;
-    shared_ptr<detail::abstract_context<clock_type, errorvalue_type>> d;
+    detail::inline_interface<abstract_type> d;
     detail::make_strand_t<clock_type, E> m;
     time_point_t<clock_type> now() const {
         return d->now();
     }
     void defer_at(time_point_t<clock_type> at, observer_interface<detail::re_defer_at_t<clock_type>, E> out) const {
-        d->defer_at(at, out);
+        d->defer_at(at, move(out));
     }
     template<class... TN>
     context as_interface() const {
@@ -118,9 +119,11 @@ struct context<defaults> {
     make_strand_type m;
 private:
     struct State {
-        explicit State(strand_type&& s) : s(s) {}
-        explicit State(const strand_type& s) : s(s) {}
+        explicit State(strand_type&& s) : s(s), sweep(detail::stop_sweep_for(this->s)) {}
+        explicit State(const strand_type& s) : s(s), sweep(detail::stop_sweep_for(this->s)) {}
         strand_type s;
+        /// the stops of the lifetime are folded into sweeps on s
+        shared_ptr<detail::stop_sweep> sweep;
     };
     state<State> s;    
 public:
@@ -131,11 +134,9 @@ public:
         , s(make_state<State>(lifetime, m(subscription{}))) {
         lifetime.insert(s.get().s.lifetime);
 #if !RX_DEFER_IMMEDIATE
-        lifetime.bind_defer([s = s.get().s](function<void()> target){
+        lifetime.bind_defer([s = s.get().s, sweep = s.get().sweep](function<void()> target){
             if (s.lifetime.is_stopped()) abort();
-            defer(s, make_observer(subscription{}, [target](auto& ){
-                return target();
-            }));
+            sweep->push(s, move(target));
         });
 #endif
     }
@@ -145,11 +146,9 @@ public:
         , s(make_state<State>(lifetime, strand)) {
         lifetime.insert(s.get().s.lifetime);
 #if !RX_DEFER_IMMEDIATE
-        lifetime.bind_defer([s = s.get().s](function<void()> target){
+        lifetime.bind_defer([s = s.get().s, sweep = s.get().sweep](function<void()> target){
             if (s.lifetime.is_stopped()) abort();
-            defer(s, make_observer(subscription{}, [target](auto& ){
-                return target();
-            }));
+            sweep->push(s, move(target));
         });
 #endif
     }
@@ -158,12 +157,13 @@ public:
     }
     template<class... ON>
     void defer_at(time_point_t<clock_type> at, observer<ON...> out) const {
-        s.get().s.defer_at(at, out);
+        // a stop that is pushed after this item does not run ahead of it
+        s.get().sweep->deferred();
+        s.get().s.defer_at(at, move(out));
     }
     template<class E = exception_ptr>
     context_interface<Clock, E> as_interface() const {
-        using context_t = detail::basic_context<Clock, E, make_strand_type>;
-        return {lifetime, make_shared<context_t>(*this)};
+        return {*this};
     }
 };
 
@@ -177,9 +177,11 @@ struct context<void, void, Clock> {
     make_strand_type m;
 private:
     struct State {
-        explicit State(strand_type&& s) : s(s) {}
-        explicit State(const strand_type& s) : s(s) {}
+        explicit State(strand_type&& s) : s(s), sweep(detail::stop_sweep_for(this->s)) {}
+        explicit State(const strand_type& s) : s(s), sweep(detail::stop_sweep_for(this->s)) {}
         strand_type s;
+        /// the stops of the lifetime are folded into sweeps on s
+        shared_ptr<detail::stop_sweep> sweep;
     };
     state<State> s;    
 public:
@@ -190,11 +192,9 @@ public:
         , s(make_state<State>(lifetime, m(subscription{}))) {
         lifetime.insert(s.get().s.lifetime);
 #if !RX_DEFER_IMMEDIATE
-        lifetime.bind_defer([s = s.get().s](function<void()> target){
+        lifetime.bind_defer([s = s.get().s, sweep = s.get().sweep](function<void()> target){
             if (s.lifetime.is_stopped()) abort();
-            defer(s, make_observer(subscription{}, [target](auto& ){
-                return target();
-            }));
+            sweep->push(s, move(target));
         });
 #endif
     }
@@ -204,11 +204,9 @@ public:
         , s(make_state<State>(lifetime, s)) {
         lifetime.insert(s.get().s.lifetime);
 #if !RX_DEFER_IMMEDIATE
-        lifetime.bind_defer([s = s.get().s](function<void()> target){
+        lifetime.bind_defer([s = s.get().s, sweep = s.get().sweep](function<void()> target){
             if (s.lifetime.is_stopped()) abort();
-            defer(s, make_observer(subscription{}, [target](auto& ){
-                return target();
-            }));
+            sweep->push(s, move(target));
         });
 #endif
     }
@@ -217,12 +215,13 @@ public:
     }
     template<class... ON>
     void defer_at(time_point_t<clock_type> at, observer<ON...> out) const {
-        s.get().s.defer_at(at, out);
+        // a stop that is pushed after this item does not run ahead of it
+        s.get().sweep->deferred();
+        s.get().s.defer_at(at, move(out));
     }
     template<class E = exception_ptr>
     context_interface<clock_type, E> as_interface() const {
-        using context_t = detail::basic_context<clock_type, E, make_strand_type>;
-        return {lifetime, make_shared<context_t>(*this)};
+        return {*this};
     }
 };
 
@@ -237,9 +236,11 @@ struct context<void, MakeStrand, Clock> {
 
 private:
     struct State {
-        explicit State(strand_type&& s) : s(s) {}
-        explicit State(const strand_type& s) : s(s) {}
+        explicit State(strand_type&& s) : s(s), sweep(detail::stop_sweep_for(this->s)) {}
+        explicit State(const strand_type& s) : s(s), sweep(detail::stop_sweep_for(this->s)) {}
         strand_type s;
+        /// the stops of the lifetime are folded into sweeps on s
+        shared_ptr<detail::stop_sweep> sweep;
     };
     state<State> s;  
 
@@ -250,11 +251,9 @@ public:
         , s(make_state<State>(lifetime, m(subscription{}))) {
         lifetime.insert(s.get().s.lifetime);
 #if !RX_DEFER_IMMEDIATE
-        lifetime.bind_defer([s = s.get().s](function<void()> target){
+        lifetime.bind_defer([s = s.get().s, sweep = s.get().sweep](function<void()> target){
             if (s.lifetime.is_stopped()) abort();
-            defer(s, make_observer(subscription{}, [target](auto& ){
-                return target();
-            }));
+            sweep->push(s, move(target));
         });
 #endif
     }
@@ -264,11 +263,9 @@ public:
         , s(make_state<State>(lifetime, s)) {
         lifetime.insert(this->s.get().s.lifetime);
 #if !RX_DEFER_IMMEDIATE
-        lifetime.bind_defer([s = this->s.get().s](function<void()> target){
+        lifetime.bind_defer([s = this->s.get().s, sweep = this->s.get().sweep](function<void()> target){
             if (s.lifetime.is_stopped()) abort();
-            defer(s, make_observer(subscription{}, [target](auto& ){
-                return target();
-            }));
+            sweep->push(s, move(target));
         });
 #endif
     }
@@ -277,12 +274,13 @@ public:
     }
     template<class... ON>
     void defer_at(time_point_t<clock_type> at, observer<ON...> out) const {
-        s.get().s.defer_at(at, out);
+        // a stop that is pushed after this item does not run ahead of it
+        s.get().sweep->deferred();
+        s.get().s.defer_at(at, move(out));
     }
     template<class E = exception_ptr>
     context_interface<Clock, E> as_interface() const {
-        using context_t = detail::basic_context<Clock, E, make_strand_type>;
-        return {lifetime, make_shared<context_t>(*this)};
+        return {*this};
     }  
 };
 
@@ -300,11 +298,9 @@ struct context<Payload, MakeStrand, Clock> {
         , s(make_state<State>(lifetime, m(subscription{}), move(p))) {
         lifetime.insert(s.get().s.lifetime);
 #if !RX_DEFER_IMMEDIATE
-        lifetime.bind_defer([s = s.get().s](function<void()> target){
+        lifetime.bind_defer([s = s.get().s, sweep = s.get().sweep](function<void()> target){
             if (s.lifetime.is_stopped()) abort();
-            defer(s, make_observer(subscription{}, [target](auto& ){
-                return target();
-            }));
+            sweep->push(s, move(target));
         });
 #endif
     }
@@ -313,12 +309,13 @@ struct context<Payload, MakeStrand, Clock> {
     }
     template<class... ON>
     void defer_at(time_point_t<clock_type> at, observer<ON...> out) const {
-        s.get().s.defer_at(at, out);
+        // a stop that is pushed after this item does not run ahead of it
+        s.get().sweep->deferred();
+        s.get().s.defer_at(at, move(out));
     }
     template<class E = exception_ptr>
     context_interface<clock_type, E> as_interface() const {
-        using context_t = detail::basic_context<clock_type, E, make_strand_type>;
-        return {lifetime, make_shared<context_t>(*this)};
+        return {*this};
     }
     payload_type& get(){
         return s.get().p;
@@ -332,10 +329,12 @@ struct context<Payload, MakeStrand, Clock> {
 private:
     using Strand = decay_t<decltype(declval<MakeStrand>()(declval<subscription>()))>;
     struct State {
-        State(strand_type&& s, payload_type&& p) : s(s), p(p) {}
-        State(const strand_type& s, const payload_type& p) : s(s), p(p) {}
+        State(strand_type&& s, payload_type&& p) : s(s), p(p), sweep(detail::stop_sweep_for(this->s)) {}
+        State(const strand_type& s, const payload_type& p) : s(s), p(p), sweep(detail::stop_sweep_for(this->s)) {}
         strand_type s;
         payload_type p;
+        /// the stops of the lifetime are folded into sweeps on s
+        shared_ptr<detail::stop_sweep> sweep;
     };
     state<State> s;    
 };
@@ -357,18 +356,12 @@ subscription defer_after(context<CN...> s, clock_duration_t<context<CN...>> dela
     return out.lifetime;
 }
 template<class... CN, class... ON>
-subscription defer_periodic(context<CN...> s, clock_time_point_t<context<CN...>> initial, clock_duration_t<context<CN...>> period, observer<ON...> out) {
-    auto lifetime = subscription{};
-    auto state = make_state<pair<long, clock_time_point_t<context<CN...>>>>(lifetime, make_pair(0, initial));
+subscription defer_periodic(context<CN...> s, clock_time_point_t<context<CN...>> initial, clock_duration_t<context<CN...>> period, observer<ON...> out, periodic_policy policy = periodic_policy::catch_up) {
     s.defer_at(initial, make_observer(
         out,
         out.lifetime, 
-        [state, period](const observer<ON...>& out, auto& self) mutable {
-            auto& s = state.get();
-            out.next(s.first++);
-            s.second += period;
-            self(s.second);
-        }, detail::pass{}, detail::skip{}));
+        detail::periodic<context<CN...>>{s, initial, period, policy, 0}, 
+        detail::pass{}, detail::skip{}));
     return out.lifetime;
 }
 
@@ -0,0 +1,120 @@
+#pragma once
+
+namespace rx {
+
+namespace detail {
+
+///
+/// \brief the credit that a consumer has requested and the producers have not used.
+/// a producer takes one unit of credit before each value. a producer without
+/// credit parks a resume function that the next request calls.
+/// once closed, parked functions are released and no more are parked.
+/// a request only takes the lock when a producer may have parked.
+///
+struct demand
+{
+    demand() : credit(0), waiting(false), closed(false) {}
+
+    /// \brief adds n to the credit and resumes the parked producers
+    void request(size_t n) {
+        auto c = credit.load(memory_order_relaxed);
+        auto limit = numeric_limits<size_t>::max();
+        while (!credit.compare_exchange_weak(c, n > limit - c ? limit : c + n)) {}
+        // pairs with park, which sets waiting before it checks the credit
+        if (!waiting.load()) {
+            return;
+        }
+        vector<function<void()>> resumed;
+        {
+            unique_lock<mutex> guard(lock);
+            waiting.store(false, memory_order_relaxed);
+            swap(resumed, parked);
+        }
+        for (auto& resume : resumed) {
+            resume();
+        }
+    }
+
+    /// \returns true when one unit of credit was taken
+    bool try_take() {
+        auto c = credit.load(memory_order_acquire);
+        while (c > 0) {
+            if (credit.compare_exchange_weak(c, c - 1, memory_order_acq_rel)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// \returns the credit that was taken, at most n
+    size_t try_take(size_t n) {
+        auto c = credit.load(memory_order_acquire);
+        while (c > 0) {
+            auto taken = c < n ? c : n;
+            if (credit.compare_exchange_weak(c, c - taken, memory_order_acq_rel)) {
+                return taken;
+            }
+        }
+        return 0;
+    }
+
+    /// \brief calls resume on the next request. once closed, resume is dropped.
+    /// \returns false, without parking resume, when there is credit
+    bool park(function<void()> resume) {
+        unique_lock<mutex> guard(lock);
+        if (closed) {
+            return true;
+        }
+        waiting.store(true);
+        if (credit.load() > 0) {
+            return false;
+        }
+        parked.push_back(move(resume));
+        return true;
+    }
+
+    /// \brief releases the parked producers without resuming them
+    void close() {
+        vector<function<void()>> expired;
+        unique_lock<mutex> guard(lock);
+        closed = true;
+        swap(expired, parked);
+        guard.unlock();
+    }
+
+private:
+    atomic<size_t> credit;
+    /// set while a producer may be parked
+    atomic<bool> waiting;
+    mutex lock;
+    bool closed;
+    vector<function<void()>> parked;
+};
+
+/// \brief takes one unit of credit from d, parking resume until there is some.
+/// \returns false when resume was parked.
+template<class Resume>
+bool take_or_park(const shared_ptr<demand>& d, Resume&& resume) {
+    while (d && !d->try_take()) {
+        if (d->park(resume)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// \brief returns the credit of the values that a lifter took in and did 
+/// not pass on. does nothing when the consumer has not opted in to demand.
+struct refund
+{
+    shared_ptr<demand> credit;
+    void operator()(size_t dropped) const {
+        if (dropped > 0 && credit) {
+            credit->request(dropped);
+        }
+    }
+};
+
+}
+
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#if !defined(RX_INLINE_INTERFACE_SIZE)
+#define RX_INLINE_INTERFACE_SIZE 128
+#endif
+
+namespace rx {
+
+namespace detail {
+
+///
+/// \brief holds an object of a type derived from Abstract.
+/// an object that fits in Size bytes is stored inline and copies of the 
+/// holder copy the object. a larger object is allocated once and copies 
+/// of the holder share it, the same as the shared_ptr that this replaces.
+/// an object whose copies must share its state is always allocated.
+///
+template<class Abstract, size_t Size = RX_INLINE_INTERFACE_SIZE>
+struct inline_interface
+{
+private:
+    struct operations
+    {
+        Abstract* (*copy)(void* to, const void* from);
+        Abstract* (*move)(void* to, void* from);
+        void (*destroy)(void* storage);
+    };
+
+    template<class Concrete>
+    struct stored_inline
+    {
+        static Abstract* copy(void* to, const void* from) {
+            return new (to) Concrete(*static_cast<const Concrete*>(from));
+        }
+        static Abstract* move(void* to, void* from) {
+            return new (to) Concrete(std::move(*static_cast<Concrete*>(from)));
+        }
+        static void destroy(void* storage) {
+            static_cast<Concrete*>(storage)->~Concrete();
+        }
+        static const operations* get() {
+            static const operations ops{&copy, &move, &destroy};
+            return &ops;
+        }
+    };
+
+    struct stored_shared
+    {
+        using pointer = shared_ptr<Abstract>;
+        static Abstract* copy(void* to, const void* from) {
+            return (new (to) pointer(*static_cast<const pointer*>(from)))->get();
+        }
+        static Abstract* move(void* to, void* from) {
+            return (new (to) pointer(std::move(*static_cast<pointer*>(from))))->get();
+        }
+        static void destroy(void* storage) {
+            static_cast<pointer*>(storage)->~pointer();
+        }
+        static const operations* get() {
+            static const operations ops{&copy, &move, &destroy};
+            return &ops;
+        }
+    };
+
+    template<class Concrete>
+    using fits = integral_constant<bool,
+        sizeof(Concrete) <= Size &&
+        alignof(Concrete) <= alignof(max_align_t) &&
+        is_nothrow_move_constructible<Concrete>::value>;
+
+    template<class Concrete, class... AN>
+    void emplace(true_type, AN&&... an) {
+        p = new (&storage) Concrete(std::forward<AN>(an)...);
+        ops = stored_inline<Concrete>::get();
+    }
+    template<class Concrete, class... AN>
+    void emplace(false_type, AN&&... an) {
+        p = (new (&storage) shared_ptr<Abstract>(make_shared<Concrete>(std::forward<AN>(an)...)))->get();
+        ops = stored_shared::get();
+    }
+
+    /// the moved-from object stays in o until o is destroyed
+    void take(inline_interface& o) {
+        if (o.ops) {
+            p = o.ops->move(&storage, &o.storage);
+            ops = o.ops;
+            o.p = nullptr;
+        }
+    }
+
+    void reset() {
+        if (ops) {
+            ops->destroy(&storage);
+            p = nullptr;
+            ops = nullptr;
+        }
+    }
+
+    Abstract* p;
+    const operations* ops;
+    typename aligned_storage<(Size > sizeof(shared_ptr<Abstract>) ? Size : sizeof(shared_ptr<Abstract>)), alignof(max_align_t)>::type storage;
+
+public:
+    /// Inline is false when copies of Concrete must share its state
+    template<class Concrete, bool Inline = true>
+    struct in_place_t {};
+
+    inline_interface() : p(nullptr), ops(nullptr) {}
+    template<class Concrete, bool Inline, class... AN>
+    explicit inline_interface(in_place_t<Concrete, Inline>, AN&&... an) : p(nullptr), ops(nullptr) {
+        emplace<Concrete>(integral_constant<bool, Inline && fits<Concrete>::value>{}, std::forward<AN>(an)...);
+    }
+    inline_interface(const inline_interface& o) : p(nullptr), ops(nullptr) {
+        if (o.p) {
+            p = o.ops->copy(&storage, &o.storage);
+            ops = o.ops;
+        }
+    }
+    inline_interface(inline_interface&& o) noexcept : p(nullptr), ops(nullptr) {
+        take(o);
+    }
+    inline_interface& operator=(const inline_interface& o) {
+        if (this != &o) {
+            inline_interface copy(o);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+    inline_interface& operator=(inline_interface&& o) noexcept {
+        if (this != &o) {
+            reset();
+            take(o);
+        }
+        return *this;
+    }
+    ~inline_interface() {
+        reset();
+    }
+
+    explicit operator bool() const {
+        return !!p;
+    }
+    Abstract* get() const {
+        return p;
+    }
+    Abstract* operator->() const {
+        return p;
+    }
+    Abstract& operator*() const {
+        return *p;
+    }
+};
+
+template<class Abstract, class Concrete, bool Inline = true, class... AN>
+inline_interface<Abstract> make_inline_interface(AN&&... an) {
+    using holder_t = inline_interface<Abstract>;
+    return holder_t(typename holder_t::template in_place_t<Concrete, Inline>{}, std::forward<AN>(an)...);
+}
+
+}
+
+}
@@ -8,13 +8,35 @@ joiner join() {
     return {};
 }
 
+template<class F>
+struct join_callback {
+    F f;
+};
+/// \brief calls f once the subscription and the nested subscriptions 
+/// that its stop swept have finished. does not block.
+template<class F>
+join_callback<decay_t<F>> on_joined(F&& f) {
+    return {forward<F>(f)};
+}
+
 /// \brief chain operator overload for
 /// void = Subscription | Joiner
 /// \param subscription
 /// \param joiner
 /// \returns void
 void operator|(subscription s, joiner ) {
-    s.join();
+    s.joined().wait();
+}
+
+/// \brief chain operator overload for
+/// Subscription = Subscription | JoinCallback
+/// \param subscription
+/// \param join_callback
+/// \returns subscription
+template<class F>
+subscription operator|(subscription s, join_callback<F> j) {
+    s.on_joined(move(j.f));
+    return s;
 }
 
-}
\ No newline at end of file
+}
@@ -52,6 +52,84 @@ lifter<Lift> make_lifter(Lift&& l) {
 
 namespace detail {
 
+template<size_t I, class Steps, class Emit>
+struct run_steps {
+    const Steps& steps;
+    const Emit& emit;
+    template<class V>
+    void operator()(V&& v) const {
+        call(integral_constant<bool, (I < tuple_size<Steps>::value)>{}, std::forward<V>(v));
+    }
+    template<class V>
+    void call(true_type, V&& v) const {
+        get<I>(steps)(run_steps<I + 1, Steps, Emit>{steps, emit}, std::forward<V>(v));
+    }
+    template<class V>
+    void call(false_type, V&& v) const {
+        emit(std::forward<V>(v));
+    }
+};
+/// \brief passes v through each step and the final value, if any, to emit
+/// \returns false when a step dropped v
+template<class Steps, class Emit, class V>
+bool run_all(const Steps& steps, const Emit& emit, V&& v) {
+    bool kept = false;
+    auto counted = [&](auto&& o){ kept = true; emit(std::forward<decltype(o)>(o)); };
+    run_steps<0, Steps, decltype(counted)>{steps, counted}(std::forward<V>(v));
+    return kept;
+}
+
+template<class V, class... StepN>
+struct fused_result {
+    using type = decay_t<V>;
+};
+template<class V, class Step, class... StepN>
+struct fused_result<V, Step, StepN...> 
+    : fused_result<decltype(declval<const Step&>().result(declval<V>())), StepN...> {
+};
+
+///
+/// \brief the lift function for a run of stateless lifters.
+/// a step is called with an emit function and a value and calls emit 
+/// with zero or one values. result(v) declares the type that it emits.
+///
+/// adjacent fused lifters are joined at composition time so that the 
+/// whole run is one observer with one lifetime check per value.
+/// the lifter returns the credit of the values that the steps dropped.
+///
+template<class... StepN>
+struct fuse {
+    tuple<StepN...> steps;
+    template<class... SN>
+    auto operator()(subscriber<SN...> scbr) const {
+        RX_TRACE("fused lifter bound to subscriber");
+        auto steps = this->steps;
+        return make_subscriber([=](auto ctx){
+            auto r = scbr.create(ctx);
+            RX_TRACE(r.lifetime.store.get(), "fused observer lifetime");
+            auto refund = detail::refund{r.lifetime.demand()};
+            auto pass = [=](auto& r, auto&& v){
+                return run_all(steps, [&](auto&& o){ r.next(std::forward<decltype(o)>(o)); }, std::forward<decltype(v)>(v));
+            };
+            return make_observer(r, r.lifetime, make_batched(
+                [=](auto& r, auto&& v){
+                    refund(pass(r, std::forward<decltype(v)>(v)) ? 0 : 1);
+                }, 
+                [=](auto& r, auto values){
+                    using result_type = typename fused_result<decltype(values[0]), StepN...>::type;
+                    // the credit of the dropped values is returned once per batch
+                    refund(stage_batches<result_type>(r, values, 
+                        [&](result_type* slot, auto& v) -> size_t {
+                            return run_all(steps, [&](auto&& o){ *slot = std::forward<decltype(o)>(o); }, v) ? 1 : 0;
+                        },
+                        [&](auto& v){
+                            return pass(r, v);
+                        }));
+                }));
+        });
+    }
+};
+
 template<class T>
 using for_lifter = for_specialization_of_t<T, lifter>;
 
@@ -60,4 +138,10 @@ using not_lifter = not_specialization_of_t<T, lifter>;
 
 }
 
+/// \brief makes a lifter from one step of a fused run. see detail::fuse
+template<class Step>
+lifter<detail::fuse<decay_t<Step>>> make_fused_lifter(Step&& step) {
+    return {detail::fuse<decay_t<Step>>{make_tuple(forward<Step>(step))}};
+}
+
 }
\ No newline at end of file
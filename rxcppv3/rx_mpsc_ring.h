@@ -0,0 +1,104 @@
+#pragma once
+
+namespace rx {
+
+namespace detail {
+
+///
+/// \brief A bounded lock-free queue with many producers and one consumer.
+/// Each cell has a sequence number that says whether it is free for the
+/// producer at a position or full for the consumer at a position. push
+/// claims a position with a CAS and then publishes the cell, so there is
+/// one slot write per value and no allocation after construction.
+/// The capacity is rounded up to a power of two.
+///
+template<class T>
+struct mpsc_ring
+{
+    explicit mpsc_ring(size_t capacity)
+        : mask(round_up(capacity) - 1)
+        , cells(new cell[mask + 1])
+        , enqueue(0)
+        , dequeue(0) {
+        for (size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, memory_order_relaxed);
+        }
+    }
+    mpsc_ring(const mpsc_ring&) = delete;
+    mpsc_ring& operator=(const mpsc_ring&) = delete;
+    ~mpsc_ring() {
+        while (consume([](T&&){})) {}
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+    /// \returns false when the ring is full. v is not moved from.
+    template<class U>
+    bool try_push(U&& v) {
+        auto position = enqueue.load(memory_order_relaxed);
+        for (;;) {
+            auto& c = cells[position & mask];
+            auto sequence = c.sequence.load(memory_order_acquire);
+            auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueue.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+                    new (&c.storage) T(forward<U>(v));
+                    c.sequence.store(position + 1, memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueue.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    /// \brief calls f with the oldest value. only called by the consumer.
+    /// \returns false when the ring is empty.
+    template<class F>
+    bool consume(F&& f) {
+        auto& c = cells[dequeue & mask];
+        if (c.sequence.load(memory_order_acquire) != dequeue + 1) {
+            return false;
+        }
+        auto& value = *reinterpret_cast<T*>(&c.storage);
+        f(move(value));
+        value.~T();
+        c.sequence.store(dequeue + mask + 1, memory_order_release);
+        ++dequeue;
+        return true;
+    }
+
+    /// \brief only called by the consumer.
+    bool empty() const {
+        return cells[dequeue & mask].sequence.load(memory_order_acquire) != dequeue + 1;
+    }
+
+private:
+    static size_t round_up(size_t capacity) {
+        size_t result = 2;
+        while (result < capacity) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    struct cell
+    {
+        atomic<size_t> sequence;
+        typename aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    const size_t mask;
+    unique_ptr<cell[]> cells;
+    alignas(64) atomic<size_t> enqueue;
+    // the consumer is serialized by the strand that it runs on
+    alignas(64) size_t dequeue;
+};
+
+}
+
+}
@@ -19,20 +19,125 @@ using for_observer = enable_if_t<observer_check<decay_t<T>>::value>;
 template<class T>
 using not_observer = enable_if_t<!observer_check<decay_t<T>>::value>;
 
+template<class F, class... AN>
+auto accepts_forwarded(int) -> decltype(declval<F&>()(declval<AN>()...), true_type{});
+template<class F, class... AN>
+false_type accepts_forwarded(long);
+
+template<class F, class... AN>
+decltype(auto) invoke_forwarded(true_type, F& f, AN&&... an) {
+    return f(std::forward<AN>(an)...);
+}
+template<class F, class... AN>
+decltype(auto) invoke_forwarded(false_type, F& f, AN&&... an) {
+    return f(an...);
+}
+/// rvalues are moved into f when f accepts them, 
+/// otherwise f is called with lvalues (eg. a lambda that takes auto&)
+template<class F, class... AN>
+decltype(auto) invoke_forwarded(F& f, AN&&... an) {
+    return invoke_forwarded(decltype(accepts_forwarded<F, AN&&...>(0)){}, f, std::forward<AN>(an)...);
+}
+
+/// the number of values that a lifter stages on the stack for next_batch
+const size_t batch_size = 256;
+
+template<class N, class... AN>
+auto accepts_batch(int) -> decltype(declval<N&>().next_batch(declval<AN>()...), true_type{});
+template<class N, class... AN>
+false_type accepts_batch(long);
+
+///
+/// \brief a next function with a batch path. 
+/// observers call next_batch with a span of values, 
+/// when Next does not have next_batch the observer calls next for each value
+///
+template<class Next, class Batch>
+struct batched {
+    Next n;
+    Batch b;
+    template<class... AN>
+    auto operator()(AN&&... an) -> decltype(n(std::forward<AN>(an)...)) {
+        return n(std::forward<AN>(an)...);
+    }
+    template<class... AN>
+    void next_batch(AN&&... an) {
+        b(std::forward<AN>(an)...);
+    }
+};
+template<class Next, class Batch>
+batched<decay_t<Next>, decay_t<Batch>> make_batched(Next&& n, Batch&& b) {
+    return {std::forward<Next>(n), std::forward<Batch>(b)};
+}
+
+/// values are only staged when they are cheap to default construct and copy
+template<class T>
+using is_stageable = integral_constant<bool, 
+    is_trivially_default_constructible<T>::value && is_trivially_copyable<T>::value>;
+
+/// \brief stages values of type T on the stack and passes each batch_size 
+/// chunk to out.next_batch(). stage(T* slot, v) writes to slot and returns 
+/// 1 to keep the value or 0 to drop it. when stage throws, the values that 
+/// were kept before it are passed on before the exception.
+/// \returns the number of values that were dropped
+template<class T, class Out, class Values, class Stage, class Each>
+size_t stage_batches(true_type, const Out& out, Values values, Stage&& stage, Each&&) {
+    T buffer[batch_size];
+    size_t count = 0;
+    size_t dropped = 0;
+    for (auto& v : values) {
+        size_t written = 0;
+        try {
+            written = stage(buffer + count, v);
+        } catch(...) {
+            if (count > 0) {
+                out.next_batch(span<const T>(buffer, count));
+            }
+            throw;
+        }
+        count += written;
+        dropped += 1 - written;
+        if (count == batch_size) {
+            out.next_batch(span<const T>(buffer, count));
+            count = 0;
+            if (out.lifetime.is_stopped()) return dropped;
+        }
+    }
+    if (count > 0) {
+        out.next_batch(span<const T>(buffer, count));
+    }
+    return dropped;
+}
+/// values that cannot be staged are passed to each(v) one at a time. 
+/// each returns false when it dropped v.
+template<class T, class Out, class Values, class Stage, class Each>
+size_t stage_batches(false_type, const Out& out, Values values, Stage&&, Each&& each) {
+    size_t dropped = 0;
+    for (auto& v : values) {
+        if (out.lifetime.is_stopped()) return dropped;
+        dropped += each(v) ? 0 : 1;
+    }
+    return dropped;
+}
+template<class T, class Out, class Values, class Stage, class Each>
+size_t stage_batches(const Out& out, Values values, Stage&& stage, Each&& each) {
+    return stage_batches<T>(is_stageable<T>{}, out, values, std::forward<Stage>(stage), std::forward<Each>(each));
+}
+
 auto report = [](auto&& e, auto&& f, auto&&... args){
-    try{f(args...);} catch(...) {e(current_exception());}
+    try{f(std::forward<decltype(args)>(args)...);} catch(...) {e(current_exception());}
 };
 
 auto enforce = [](const subscription& lifetime, auto&& f) {
     return [&](auto&&... args){
-        if (!lifetime.is_stopped()) f(args...);
+        if (!lifetime.is_stopped()) invoke_forwarded(f, std::forward<decltype(args)>(args)...);
     };
 };
 
 auto end = [](const subscription& lifetime, auto&& f, auto&&... cap) {
     return [&](auto&&... args){
         if (!lifetime.is_stopped()) { 
-            f(cap..., args...); 
+            invoke_forwarded(f, cap..., std::forward<decltype(args)>(args)...); 
             lifetime.stop();
         }
     };
@@ -47,6 +152,13 @@ struct noop
     void operator()(const Delegatee& d, V&& v) const {
         d.next(std::forward<V>(v));
     }
+    template<class V>
+    void next_batch(span<V>) const {
+    }
+    template<class Delegatee, class V>
+    void next_batch(const Delegatee& d, span<V> values) const {
+        d.next_batch(values);
+    }
     inline void operator()() const {
     }
     template<class Delegatee, class Check = for_observer<Delegatee>>
@@ -88,12 +200,12 @@ struct fail
 {
     template<class E>
     void operator()(E&&) const {
-        info("abort! ");
+        RX_TRACE("abort!");
         std::abort();
     }
     template<class Delegatee, class E, class CheckD = for_observer<Delegatee>>
     void operator()(const Delegatee&, E&&) const {
-        info("abort! ");
+        RX_TRACE("abort!");
         std::abort();
     }
 };
@@ -106,10 +218,24 @@ namespace detail{
     {
         virtual ~abstract_observer(){}
         virtual void next(const V&) const = 0;
+        virtual void next(V&&) const = 0;
+        virtual void next_batch(span<const V>) const = 0;
         virtual void error(const E&) const = 0;
         virtual void complete() const = 0;
     };
 
+    /// true when a copy of T behaves the same as T. functions with no 
+    /// data and observer interfaces, which share their observer, qualify.
+    /// an observer with stateful functions (eg. a mutable lambda) does not,
+    /// so the copies of its interface share one observer.
+    template<class T>
+    struct copies_share : public is_empty<T> {};
+    template<class V, class E>
+    struct copies_share<observer<interface<V, E>>> : public true_type {};
+    template<class... ON>
+    struct copies_share<observer<ON...>> 
+        : public is_same<integer_sequence<bool, true, copies_share<ON>::value...>, integer_sequence<bool, copies_share<ON>::value..., true>> {};
+
     template<class V, class E, class... ON>
     struct basic_observer : public abstract_observer<V, E> {
         using value_type = decay_t<V>;
@@ -121,6 +247,12 @@ namespace detail{
         virtual void next(const value_type& v) const {
             d.next(v);
         }
+        virtual void next(value_type&& v) const {
+            d.next(move(v));
+        }
+        virtual void next_batch(span<const value_type> values) const {
+            d.next_batch(values);
+        }
         virtual void error(const errorvalue_type& err) const {
             d.error(err);
         }
@@ -133,17 +265,27 @@ template<class V, class E>
 struct observer<interface<V, E>> {
     using value_type = decay_t<V>;
     using errorvalue_type = decay_t<E>;
+    using abstract_type = detail::abstract_observer<value_type, errorvalue_type>;
     observer(const observer& o) = default;
+    observer(observer&& o) = default;
+    observer& operator=(const observer& o) = default;
+    observer& operator=(observer&& o) = default;
     template<class... ON>
     observer(const observer<ON...>& o)
         : lifetime(o.lifetime)
-        , d(make_shared<detail::basic_observer<V, E, ON...>>(o)) {
+        , d(detail::make_inline_interface<abstract_type, detail::basic_observer<V, E, ON...>, detail::copies_share<observer<ON...>>::value>(o)) {
     }
     subscription lifetime;
-    shared_ptr<detail::abstract_observer<value_type, errorvalue_type>> d;
+    detail::inline_interface<abstract_type> d;
     void next(const value_type& v) const {
         d->next(v);
     }
+    void next(value_type&& v) const {
+        d->next(move(v));
+    }
+    void next_batch(span<const value_type> values) const {
+        d->next_batch(values);
+    }
     void error(const errorvalue_type& err) const {
         d->error(err);
     }
@@ -170,6 +312,22 @@ struct observer<Next, Error, Complete> {
         using namespace detail;
         report(end(lifetime, e), enforce(lifetime, n), std::forward<V>(v));
     }
+    template<class V>
+    void next_batch(span<V> values) const {
+        next_batch(values, decltype(detail::accepts_batch<Next, span<V>>(0)){});
+    }
+    template<class V>
+    void next_batch(span<V> values, true_type) const {
+        using namespace detail;
+        report(end(lifetime, e), enforce(lifetime, [this](span<V> vs){ n.next_batch(vs); }), values);
+    }
+    template<class V>
+    void next_batch(span<V> values, false_type) const {
+        for (auto& v : values) {
+            if (lifetime.is_stopped()) return;
+            next(v);
+        }
+    }
     template<class E>
     void error(E&& err) const {
         using namespace detail;
@@ -181,8 +339,7 @@ struct observer<Next, Error, Complete> {
     }
     template<class V, class E = exception_ptr>
     observer_interface<V, E> as_interface() const {
-        using observer_t = detail::basic_observer<V, E, Next, Error, Complete>;
-        return {lifetime, make_shared<observer_t>(*this)};
+        return {*this};
     }
 };
 template<class Delegatee, class Next, class Error, class Complete>
@@ -197,6 +354,22 @@ struct observer<Delegatee, Next, Error, Complete> {
         using namespace detail;
         report(end(lifetime, e, d), enforce(lifetime, n), d, std::forward<V>(v));
     }
+    template<class V>
+    void next_batch(span<V> values) const {
+        next_batch(values, decltype(detail::accepts_batch<Next, const Delegatee&, span<V>>(0)){});
+    }
+    template<class V>
+    void next_batch(span<V> values, true_type) const {
+        using namespace detail;
+        report(end(lifetime, e, d), enforce(lifetime, [this](const Delegatee& d, span<V> vs){ n.next_batch(d, vs); }), d, values);
+    }
+    template<class V>
+    void next_batch(span<V> values, false_type) const {
+        for (auto& v : values) {
+            if (lifetime.is_stopped()) return;
+            next(v);
+        }
+    }
     template<class E>
     void error(E&& err) const {
         using namespace detail;
@@ -208,8 +381,7 @@ struct observer<Delegatee, Next, Error, Complete> {
     }
     template<class V, class E = exception_ptr>
     observer_interface<V, E> as_interface() const {
-        using observer_t = detail::basic_observer<V, E, Delegatee, Next, Error, Complete>;
-        return {lifetime, make_shared<observer_t>(*this)};
+        return {*this};
     }
 };
 
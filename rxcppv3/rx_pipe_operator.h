@@ -20,10 +20,22 @@ auto operator|(lifter<LN...> l, subscriber<SN...> scbr) {
 template<class... LLN, class... LRN>
 auto operator|(lifter<LLN...> lhs, lifter<LRN...> rhs) {
     return make_lifter([lhs = move(lhs), rhs = move(rhs)](auto scbr){
-        lhs.lift(rhs.lift(scbr));
+        return lhs.lift(rhs.lift(scbr));
     });
 }
 
+/// \brief chain operator overload for
+/// Lifter = FusedLifter | FusedLifter
+/// the steps are joined into one lifter. see detail::fuse
+/// \param lifter
+/// \param lifter
+/// \returns Lifter
+template<class... LSN, class... RSN>
+auto operator|(lifter<detail::fuse<LSN...>> lhs, lifter<detail::fuse<RSN...>> rhs) {
+    using fused_t = detail::fuse<LSN..., RSN...>;
+    return lifter<fused_t>{fused_t{tuple_cat(move(lhs.l.steps), move(rhs.l.steps))}};
+}
+
 namespace detail {
 
 template<typename O, typename L>
@@ -49,6 +61,17 @@ auto operator|(observable<ON...> s, lifter<LN...> l) {
     return make_observable(detail::o_l<observable<ON...>, lifter<LN...>>{s, l});
 }
 
+/// \brief chain operator overload for
+/// Observable = Observable | FusedLifter
+/// a fused lifter that follows a fused lifter is joined with it. see detail::fuse
+/// \param observable
+/// \param lifter
+/// \returns observable
+template<class O, class... LSN, class... RSN>
+auto operator|(observable<detail::o_l<O, lifter<detail::fuse<LSN...>>>> s, lifter<detail::fuse<RSN...>> l) {
+    return s.b.o | (s.b.l | l);
+}
+
 
 /// \brief chain operator overload for
 /// Starter = Observable | Subscriber
@@ -0,0 +1,106 @@
+#pragma once
+
+namespace rx {
+
+namespace detail {
+
+///
+/// \brief An unbounded lock-free queue with one producer and one consumer.
+/// Values are written to fixed size chunks. The producer publishes each
+/// value with one release store of the chunk count and links a new chunk
+/// when the last one is full. The consumer hands an emptied chunk back to
+/// the producer, so a queue that stays short does not allocate.
+///
+template<class T, size_t ChunkSize = 256>
+struct spsc_queue
+{
+    spsc_queue()
+        : head(new chunk)
+        , tail(head)
+        , spare(nullptr) {
+    }
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+    ~spsc_queue() {
+        while (consume([](T&&){})) {}
+        delete head;
+        delete spare.load(memory_order_acquire);
+    }
+
+    /// \brief only called by the producer.
+    template<class U>
+    void push(U&& v) {
+        auto count = tail->written.load(memory_order_relaxed);
+        if (count == ChunkSize) {
+            auto c = spare.exchange(nullptr, memory_order_acquire);
+            if (!c) {
+                c = new chunk;
+            }
+            tail->next.store(c, memory_order_release);
+            tail = c;
+            count = 0;
+        }
+        new (&tail->cells[count]) T(forward<U>(v));
+        tail->written.store(count + 1, memory_order_release);
+    }
+
+    /// \brief calls f with the oldest value. only called by the consumer.
+    /// \returns false when the queue is empty.
+    template<class F>
+    bool consume(F&& f) {
+        for (;;) {
+            if (head->read < head->written.load(memory_order_acquire)) {
+                auto& value = *reinterpret_cast<T*>(&head->cells[head->read]);
+                f(move(value));
+                value.~T();
+                ++head->read;
+                return true;
+            }
+            auto next = head->read == ChunkSize ? head->next.load(memory_order_acquire) : nullptr;
+            if (!next) {
+                return false;
+            }
+            auto emptied = head;
+            head = next;
+            recycle(emptied);
+        }
+    }
+
+    /// \brief only called by the consumer.
+    bool empty() const {
+        return head->read == head->written.load(memory_order_acquire) &&
+            (head->read < ChunkSize || !head->next.load(memory_order_acquire));
+    }
+
+private:
+    struct chunk
+    {
+        chunk() : written(0), read(0), next(nullptr) {}
+        typename aligned_storage<sizeof(T), alignof(T)>::type cells[ChunkSize];
+        atomic<size_t> written;
+        // only used by the consumer
+        size_t read;
+        atomic<chunk*> next;
+    };
+
+    void recycle(chunk* c) {
+        c->written.store(0, memory_order_relaxed);
+        c->read = 0;
+        c->next.store(nullptr, memory_order_relaxed);
+        delete spare.exchange(c, memory_order_release);
+    }
+
+    // padded rather than aligned, so that new does not need the C++17
+    // over-aligned allocation. 64 bytes apart is never one cache line.
+    // only used by the consumer
+    chunk* head;
+    char pad0[64 - sizeof(chunk*)];
+    // only used by the producer
+    chunk* tail;
+    char pad1[64 - sizeof(chunk*)];
+    atomic<chunk*> spare;
+};
+
+}
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+namespace rx {
+
+namespace detail {
+
+///
+/// \brief header for each payload placed in a state_arena.
+/// records are pushed on an atomic_stack so they are destroyed
+/// in the reverse order that they were made.
+///
+struct state_record
+{
+    explicit state_record(void (*d)(state_record*)) : destroy(d), next(nullptr) {}
+    void (*destroy)(state_record*);
+    state_record* next;
+};
+
+template<class Payload>
+struct typed_state_record : public state_record
+{
+    template<class... ArgN>
+    explicit typed_state_record(ArgN&&... argn)
+        : state_record(&typed_state_record::destroy_record)
+        , value(forward<ArgN>(argn)...) {
+    }
+    static void destroy_record(state_record* r) {
+        static_cast<typed_state_record*>(r)->~typed_state_record();
+    }
+    Payload value;
+};
+
+///
+/// \brief A bump allocator for the state of one lifetime.
+/// The first block is inline so that small states are allocated with
+/// the lifetime. Later blocks grow in chunks that double in size, or
+/// are sized from the hint passed to reserve(). Memory is only released
+/// when the arena is destroyed.
+///
+template<size_t InlineSize>
+struct state_arena
+{
+    struct chunk
+    {
+        chunk(chunk* prev, char* data, size_t capacity)
+            : prev(prev)
+            , data(data)
+            , capacity(capacity)
+            , used(0) {
+        }
+        chunk* prev;
+        char* data;
+        size_t capacity;
+        atomic<size_t> used;
+
+        void* try_allocate(size_t size, size_t align) {
+            auto base = reinterpret_cast<uintptr_t>(data);
+            auto u = used.load(memory_order_relaxed);
+            size_t offset = 0;
+            do {
+                offset = ((base + u + align - 1) & ~(uintptr_t(align) - 1)) - base;
+                if (offset + size > capacity) {
+                    return nullptr;
+                }
+            } while (!used.compare_exchange_weak(u, offset + size, memory_order_relaxed));
+            return data + offset;
+        }
+        size_t available() const {
+            return capacity - min(capacity, used.load(memory_order_relaxed));
+        }
+    };
+
+    state_arena()
+        : first(nullptr, storage, InlineSize)
+        , current(&first) {
+    }
+    state_arena(const state_arena&) = delete;
+    state_arena& operator=(const state_arena&) = delete;
+    ~state_arena() {
+        auto c = current.load(memory_order_acquire);
+        while (c != &first) {
+            auto prev = c->prev;
+            c->~chunk();
+            ::operator delete(c);
+            c = prev;
+        }
+    }
+
+    /// \brief makes sure that the next size bytes will not need to grow
+    void reserve(size_t size) {
+        auto c = current.load(memory_order_acquire);
+        if (c->available() < size) {
+            grow(c, size);
+        }
+    }
+
+    void* allocate(size_t size, size_t align) {
+        for (;;) {
+            auto c = current.load(memory_order_acquire);
+            if (auto p = c->try_allocate(size, align)) {
+                return p;
+            }
+            grow(c, size + align);
+        }
+    }
+
+    template<class Payload, class... ArgN>
+    typed_state_record<Payload>* make(ArgN&&... argn) {
+        using record_type = typed_state_record<Payload>;
+        auto p = allocate(sizeof(record_type), alignof(record_type));
+        return new (p) record_type(forward<ArgN>(argn)...);
+    }
+
+private:
+    void grow(chunk* c, size_t size) {
+        auto capacity = max(size, c->capacity * 2);
+        auto raw = ::operator new(sizeof(chunk) + capacity);
+        auto n = new (raw) chunk(c, static_cast<char*>(raw) + sizeof(chunk), capacity);
+        if (!current.compare_exchange_strong(c, n, memory_order_acq_rel)) {
+            // another thread grew the arena first
+            n->~chunk();
+            ::operator delete(raw);
+        }
+    }
+
+    chunk first;
+    alignas(max_align_t) char storage[InlineSize];
+    atomic<chunk*> current;
+};
+
+}
+
+}
@@ -32,7 +32,7 @@ namespace detail {
             return d.now();
         }
         virtual void defer_at(clock_time_point_t<basic_strand> at, observer_interface<re_defer_at_t<C>, E> out) const {
-            d.defer_at(at, out);
+            d.defer_at(at, move(out));
         }
     };
 
@@ -43,19 +43,19 @@ namespace detail {
         void operator()(time_point_t<Clock> at, observer<ON...> out) const {
             auto next = at;
             bool stop = false;
-            info("immediate::defer_at");
+            RX_TRACE("immediate::defer_at");
             while (!stop && !lifetime.is_stopped() && !out.lifetime.is_stopped()) {
-                info("immediate::defer_at sleep_until");
+                RX_TRACE("immediate::defer_at sleep_until");
                 this_thread::sleep_until(next);
                 stop = true;
-                info("immediate::defer_at next");
+                RX_TRACE("immediate::defer_at next");
                 out.next([&](typename Clock::time_point at){
-                    info("immediate::defer_at self");
+                    RX_TRACE("immediate::defer_at self");
                     stop = false;
                     next = at;
                 });
             }
-            info("immediate::defer_at complete");
+            RX_TRACE("immediate::defer_at complete");
             out.complete();
         }
     };
@@ -66,25 +66,159 @@ namespace detail {
             return Clock::now();
         }
     };
+
+    ///
+    /// \brief coalesces the stop of many lifetimes into deferred sweeps.
+    /// a stop is folded into the last sweep only while nothing else has been
+    /// deferred to the strand since that sweep, otherwise a new sweep is 
+    /// deferred. so the stops keep their order with the other items on the 
+    /// strand. stops that are pushed while a sweep is running (nested 
+    /// lifetimes) are run by the same sweep under the same rule. when the 
+    /// strand drops a sweep, each of its stops is deferred to the strand 
+    /// that pushed it.
+    ///
+    struct stop_sweep : public enable_shared_from_this<stop_sweep>
+    {
+        struct node
+        {
+            function<void()> target;
+            /// defers a target to the strand that pushed this node
+            function<void(function<void()>)> home;
+        };
+        /// the stops of one deferred sweep
+        struct batch
+        {
+            explicit batch(size_t epoch) : epoch(epoch), ran(false) {}
+            /// the count of items deferred to the strand when this sweep was deferred
+            const size_t epoch;
+            atomic<bool> ran;
+            vector<node> nodes;
+        };
+
+        stop_sweep() : epoch(0) {}
+        stop_sweep(const stop_sweep&) = delete;
+        stop_sweep& operator=(const stop_sweep&) = delete;
+
+        /// \brief counts an item that is deferred to the strand. called before the item is queued
+        void deferred() {
+            epoch.fetch_add(1, memory_order_relaxed);
+        }
+
+        /// \brief runs target on s. a target that s drops is run by the drop.
+        template<class Strand>
+        static void defer_target(const Strand& s, function<void()> target) {
+            subscription lifetime;
+            lifetime.insert(move(target));
+            defer(s, make_observer(lifetime));
+        }
+
+        template<class Strand>
+        void push(const Strand& s, function<void()> target) {
+            node n{move(target), [s](function<void()> t){
+                defer_target(s, move(t));
+            }};
+            unique_lock<mutex> guard(lock);
+            auto e = epoch.load(memory_order_relaxed);
+            if (open && open->epoch == e) {
+                // the sweep is still the newest item on the strand
+                open->nodes.push_back(move(n));
+                return;
+            }
+            auto b = make_shared<batch>(e);
+            b->nodes.push_back(move(n));
+            open = b;
+            guard.unlock();
+
+            RX_TRACE(this, "stop_sweep: defer sweep");
+            // a stopped strand drops the sweep without running it. the 
+            // stops that other strands pushed must not run on the thread 
+            // that dropped it, so they are deferred to their own strands.
+            auto self = this->shared_from_this();
+            subscription lifetime;
+            lifetime.insert([self, b](){
+                if (!b->ran.load()) {
+                    self->drain(*b, [](node& n){
+                        n.home(move(n.target));
+                    });
+                }
+            });
+            defer(s, make_observer(lifetime, [self, b](auto& ){
+                b->ran.store(true);
+                self->drain(*b, [&](node& n){
+                    RX_TRACE(self.get(), "stop_sweep: stop");
+                    n.target();
+                });
+            }));
+        }
+
+    private:
+        template<class Run>
+        void drain(batch& b, Run&& run) {
+            for (;;) {
+                vector<node> nodes;
+                {
+                    unique_lock<mutex> guard(lock);
+                    swap(nodes, b.nodes);
+                    if (nodes.empty()) {
+                        if (open.get() == &b) {
+                            open.reset();
+                        }
+                        return;
+                    }
+                }
+                // in the order that the stops were pushed
+                for (auto& n : nodes) {
+                    run(n);
+                }
+            }
+        }
+
+        atomic<size_t> epoch;
+        mutex lock;
+        /// the last sweep that was deferred, until it has run
+        shared_ptr<batch> open;
+    };
+
+    /// strands that share an executor can provide a shared stop_sweep with a sweep() member
+    template<class Execute>
+    auto stop_sweep_of(const Execute& e, int) -> decltype(e.sweep()) {
+        return e.sweep();
+    }
+    template<class Execute>
+    shared_ptr<stop_sweep> stop_sweep_of(const Execute&, ...) {
+        return make_shared<stop_sweep>();
+    }
+
+    /// strand makers that place their threads can provide a near(other) member 
+    /// that returns a maker for strands placed with those of other
+    template<class MakeStrand, class Other>
+    auto colocate(const MakeStrand& m, const Other& other, int) -> decltype(m.near(other)) {
+        return m.near(other);
+    }
+    template<class MakeStrand, class Other>
+    MakeStrand colocate(const MakeStrand& m, const Other&, ...) {
+        return m;
+    }
 }
 
 template<class C, class E>
 struct strand<interface<C, E>> {
     using clock_type = decay_t<C>;
     using errorvalue_type = decay_t<E>;
+    using abstract_type = detail::abstract_strand<clock_type, errorvalue_type>;
     strand(const strand& o) = default;
     template<class Execute, class Now>
     strand(const strand<Execute, Now, C>& o)
         : lifetime(o.lifetime)
-        , d(make_shared<detail::basic_strand<C, E, Execute, Now>>(o)) {
+        , d(detail::make_inline_interface<abstract_type, detail::basic_strand<C, E, Execute, Now>>(o)) {
     }
     subscription lifetime;
-    shared_ptr<detail::abstract_strand<clock_type, errorvalue_type>> d;
+    detail::inline_interface<abstract_type> d;
     time_point_t<clock_type> now() const {
         return d->now();
     }
     void defer_at(time_point_t<clock_type> at, observer_interface<detail::re_defer_at_t<C>, E> out) const {
-        d->defer_at(at, out);
+        d->defer_at(at, move(out));
     }
     template<class... TN>
     strand as_interface() const {
@@ -105,12 +239,11 @@ struct strand<Execute, Now, Clock> {
     }
     template<class... ON>
     void defer_at(time_point_t<clock_type> at, observer<ON...> out) const {
-        e(at, out);
+        e(at, move(out));
     }
     template<class E = exception_ptr>
     strand_interface<Clock, E> as_interface() const {
-        using strand_t = detail::basic_strand<Clock, E, Execute, Now>;
-        return {lifetime, make_shared<strand_t>(*this)};
+        return {*this};
     }
 };
 
@@ -127,14 +260,33 @@ template<class Strand>
 struct shared_strand {
     using strand_type = decay_t<Strand>;
     template<class F>
-    explicit shared_strand(F&& f, detail::shared_strand_construct_t&&) : st(forward<F>(f)) {}
+    explicit shared_strand(F&& f, detail::shared_strand_construct_t&&) 
+        : st(forward<F>(f))
+        , sweep(make_shared<detail::stop_sweep>()) {
+    }
     strand_type st;
+    /// the stops deferred to any strand made by the maker are swept together
+    shared_ptr<detail::stop_sweep> sweep;
     ~shared_strand() {
-        info("shared_strand: destroy stop");
+        RX_TRACE("shared_strand: destroy stop");
         st.lifetime.stop();
     }
 };
 
+template<class Strand>
+struct shared_strand_execute {
+    shared_ptr<shared_strand<Strand>> ss;
+    subscription lifetime;
+    template<class At, class O>
+    void operator()(At at, O o) const {
+        lifetime.insert(o.lifetime);
+        ss->st.defer_at(at, move(o));
+    }
+    shared_ptr<detail::stop_sweep> sweep() const {
+        return ss->sweep;
+    }
+};
+
 template<class Strand>
 struct shared_strand_maker {
     using strand_type = decay_t<Strand>;
@@ -142,10 +294,7 @@ struct shared_strand_maker {
     auto operator()(subscription lifetime) const {
         ss->st.lifetime.insert(lifetime);
         return make_strand<clock_t<strand_type>>(lifetime, 
-            [ss = this->ss, lifetime](auto at, auto o){
-                lifetime.insert(o.lifetime);
-                ss->st.defer_at(at, o);
-            },
+            shared_strand_execute<strand_type>{ss, lifetime},
             [ss = this->ss](){return ss->st.now();});
     }
 };
@@ -171,6 +320,64 @@ using for_strand = for_specialization_of_t<T, strand>;
 template<class T>
 using not_strand = not_specialization_of_t<T, strand>;
 
+template<class Execute, class Now, class Clock>
+shared_ptr<stop_sweep> stop_sweep_for(const strand<Execute, Now, Clock>& s) {
+    return stop_sweep_of(s.e, 0);
+}
+template<class Strand>
+shared_ptr<stop_sweep> stop_sweep_for(const Strand&) {
+    return make_shared<stop_sweep>();
+}
+
+}
+
+/// what defer_periodic does with the ticks that came due while the strand was behind
+enum class periodic_policy {
+    /// every tick is delivered. the ticks that are due are passed in one batch.
+    catch_up,
+    /// only the latest tick that is due is delivered. the values of the others are skipped.
+    skip
+};
+
+namespace detail {
+
+///
+/// \brief the deferred observer of defer_periodic.
+/// the tick count is kept in place and the observer re-arms itself, so a tick 
+/// does not allocate. tick n is due at initial + n * period, so the ticks do not drift.
+///
+template<class S>
+struct periodic
+{
+    S s;
+    clock_time_point_t<S> initial;
+    clock_duration_t<S> period;
+    periodic_policy policy;
+    long count;
+
+    template<class Out, class Self>
+    void operator()(const Out& out, Self& self) {
+        auto due = initial + period * count;
+        auto now = s.now();
+        // the latest tick that is due
+        auto latest = now > due ? count + static_cast<long>((now - due) / period) : count;
+        if (policy == periodic_policy::skip || latest == count) {
+            count = latest;
+            out.next(count++);
+        } else {
+            long batch[batch_size];
+            while (count <= latest && !out.lifetime.stop_requested()) {
+                size_t size = 0;
+                while (size < batch_size && count <= latest) {
+                    batch[size++] = count++;
+                }
+                out.next_batch(span<const long>(batch, size));
+            }
+        }
+        self(initial + period * count);
+    }
+};
+
 }
 
 template<class... SN, class... ON>
@@ -189,18 +396,12 @@ subscription defer_after(strand<SN...> s, clock_duration_t<strand<SN...>> delay,
     return out.lifetime;
 }
 template<class... SN, class... ON>
-subscription defer_periodic(strand<SN...> s, clock_time_point_t<strand<SN...>> initial, clock_duration_t<strand<SN...>> period, observer<ON...> out) {
-    auto lifetime = subscription{};
-    auto state = make_state<pair<long, clock_time_point_t<strand<SN...>>>>(lifetime, make_pair(0, initial));
+subscription defer_periodic(strand<SN...> s, clock_time_point_t<strand<SN...>> initial, clock_duration_t<strand<SN...>> period, observer<ON...> out, periodic_policy policy = periodic_policy::catch_up) {
     s.defer_at(initial, make_observer(
         out,
         out.lifetime, 
-        [state, period](const observer<ON...>& out, auto& self) mutable {
-            auto& s = state.get();
-            out.next(s.first++);
-            s.second += period;
-            self(s.second);
-        }, detail::pass{}, detail::skip{}));
+        detail::periodic<strand<SN...>>{s, initial, period, policy, 0}, 
+        detail::pass{}, detail::skip{}));
     return out.lifetime;
 }
 
@@ -19,36 +19,356 @@ struct subscription
 private:
     using lock_type = mutex;
     using guard_type = unique_lock<lock_type>;
-    struct finish
+    using defer_type = function<void(function<void()>)>;
+    /// the first 128 bytes of state are allocated with the lifetime
+    using arena_type = detail::state_arena<128>;
+#if RX_LOCKFREE_SUBSCRIPTION
+    struct shared;
+    struct finish;
+    /// a nested lifetime. the parent list owns the entry through keep, 
+    /// the nested lifetime only holds a weak reference to mark it erased.
+    /// the first to claim a live entry owns store and signal. an erase 
+    /// releases them, a stop sweep keeps them for join.
+    struct nested
+    {
+        enum status_type { live, erased, swept };
+        nested(shared_ptr<shared> st, shared_ptr<finish> s) 
+            : key(st.get())
+            , store(move(st))
+            , signal(move(s))
+            , status(live)
+            , next(nullptr) {
+        }
+        bool claim(status_type to) {
+            int expected = live;
+            return status.compare_exchange_strong(expected, to);
+        }
+        void release() {
+            auto st = move(store);
+            auto si = move(signal);
+        }
+        shared* const key;
+        shared_ptr<shared> store;
+        shared_ptr<finish> signal;
+        atomic<int> status;
+        nested* next;
+        shared_ptr<nested> keep;
+    };
+    struct stopper
+    {
+        explicit stopper(function<void()> f) : f(move(f)), next(nullptr) {}
+        function<void()> f;
+        stopper* next;
+    };
+    struct scope
+    {
+        explicit scope(weak_ptr<shared> w) : w(move(w)), next(nullptr) {}
+        weak_ptr<shared> w;
+        scope* next;
+    };
+    template<class Node, class F>
+    static void drain(Node* n, F&& f) {
+        while (n) {
+            unique_ptr<Node> current(n);
+            n = n->next;
+            f(*current);
+        }
+    }
+#else
+    struct shared;
+    struct finish;
+    /// links a nested lifetime into the list of a parent. the first
+    /// link is embedded in the nested lifetime. the parent lock guards
+    /// prev, next and keep.
+    struct hook
+    {
+        hook() : prev(nullptr), next(nullptr) {}
+        hook* prev;
+        hook* next;
+        /// the reference that the parent holds on the nested store.
+        /// empty when unlinked
+        shared_ptr<shared> keep;
+        shared_ptr<finish> signal;
+        weak_ptr<finish> parent;
+    };
+#endif
+    struct finish : public enable_shared_from_this<finish>
     {
         finish() 
             : stopped(false)
-            , joined(false) {
+            , outstanding(1)
+            , joined(false)
+            , requested(false) {
+#if RX_LOCKFREE_SUBSCRIPTION
+            count = 0;
+            erased = 0;
+            swept = nullptr;
+            maintenance.clear();
+#endif
+        }
+#if RX_LOCKFREE_SUBSCRIPTION
+        ~finish() {
+            auto n = swept ? swept : others.close();
+            while (n) {
+                auto next = n->next;
+                n->keep.reset();
+                n = next;
+            }
+        }
+        /// pushes and closes do not lock. walking or unlinking the 
+        /// others chain requires maintenance.
+        void lock_maintenance() {
+            while (maintenance.test_and_set(memory_order_acquire)) {
+                this_thread::yield();
+            }
+        }
+        void unlock_maintenance() {
+            maintenance.clear(memory_order_release);
+        }
+        /// called once for each nested lifetime that is erased
+        void erase_one() {
+            auto e = ++erased;
+            if (e > 64 && e * 2 > count) {
+                compact();
+            }
+        }
+        /// releases the erased entries
+        void compact() {
+            if (maintenance.test_and_set(memory_order_acquire)) {
+                // already compacting
+                return;
+            }
+            auto chain = others.take();
+            nested* first = nullptr;
+            nested* last = nullptr;
+            while (chain) {
+                auto n = chain;
+                chain = chain->next;
+                if (n->status == nested::erased) {
+                    --count;
+                    --erased;
+                    n->keep.reset();
+                    continue;
+                }
+                n->next = nullptr;
+                if (last) {
+                    last->next = n;
+                } else {
+                    first = n;
+                }
+                last = n;
+            }
+            // close() only happens under maintenance, so splice cannot fail
+            if (first && !others.splice(first, last)) {
+                abort();
+            }
+            unlock_maintenance();
+        }
+        detail::atomic_stack<nested> others;
+        atomic<size_t> count;
+        atomic<size_t> erased;
+        atomic_flag maintenance;
+        nested* swept;
+#else
+        ~finish() {
+            while (others) {
+                auto h = others;
+                others = h->next;
+                h->prev = h->next = nullptr;
+                // may destroy the store that holds h
+                auto expired = move(h->keep);
+            }
+        }
+        void link(hook* h) {
+            h->prev = nullptr;
+            h->next = others;
+            if (others) {
+                others->prev = h;
+            }
+            others = h;
+        }
+        void unlink(hook* h) {
+            if (h->prev) {
+                h->prev->next = h->next;
+            } else {
+                others = h->next;
+            }
+            if (h->next) {
+                h->next->prev = h->prev;
+            }
+            h->prev = h->next = nullptr;
         }
         lock_type lock;
-        set<subscription> others;
+        hook* others = nullptr;
+#endif
+        /// \brief sets requested on this lifetime and on the lifetimes nested
+        /// in it. each lifetime is walked once, by the first request.
+        void request_stop() {
+            if (requested.exchange(true)) {
+                return;
+            }
+            vector<shared_ptr<finish>> walk;
+            request_nested(walk);
+            while (!walk.empty()) {
+                auto f = move(walk.back());
+                walk.pop_back();
+                f->request_nested(walk);
+            }
+        }
+        /// \brief sets requested on the lifetimes nested in this one and 
+        /// adds the ones that were not already requested to walk
+        void request_nested(vector<shared_ptr<finish>>& walk) {
+#if RX_LOCKFREE_SUBSCRIPTION
+            // pairs with the fence in insert, either the walk finds the 
+            // nested lifetime or insert finds this one requested
+            atomic_thread_fence(memory_order_seq_cst);
+            lock_maintenance();
+            for (auto n = others.peek(); n; n = n->next) {
+                if (n->status == nested::live && !n->signal->requested.exchange(true)) {
+                    walk.push_back(n->signal);
+                }
+            }
+            unlock_maintenance();
+#else
+            guard_type guard(lock);
+            for (auto h = others; h; h = h->next) {
+                if (!h->signal->requested.exchange(true)) {
+                    walk.push_back(h->signal);
+                }
+            }
+#endif
+        }
+        /// \brief registers f to be called once this lifetime and the
+        /// nested lifetimes that its stop swept have all finished stopping.
+        /// f is called now if that has already happened.
+        void on_joined(function<void()> f) {
+            {
+                unique_lock<mutex> guard(joinlock);
+                if (!joined) {
+                    joiners.push_back(move(f));
+                    return;
+                }
+            }
+            f();
+        }
+        /// \brief adds a nested lifetime that must finish before this one is joined
+        void join_one(const shared_ptr<finish>& nested) {
+            ++outstanding;
+            nested->on_joined([w = weak_ptr<finish>(shared_from_this())](){
+                if (auto p = w.lock()) {
+                    p->release_one();
+                }
+            });
+        }
+        /// \brief called once for the stop of this lifetime and once for
+        /// each nested lifetime added by join_one.
+        void release_one() {
+            if (--outstanding != 0) {
+                return;
+            }
+            vector<function<void()>> expired;
+            {
+                unique_lock<mutex> guard(joinlock);
+                joined = true;
+                swap(expired, joiners);
+            }
+            for (auto& f : expired) {
+                f();
+            }
+        }
         atomic<bool> stopped;
+        atomic<size_t> outstanding;
         mutex joinlock;
         atomic<bool> joined;
-        condition_variable joinwake;
+        vector<function<void()>> joiners;
+        /// empty until the lifetime opts in to demand
+        shared_ptr<detail::demand> demand;
+        /// set before stopped, on this lifetime and on every lifetime 
+        /// nested in it, so that a poll is one load
+        atomic<bool> requested;
     };
     struct shared
     {
         ~shared(){
-            info(to_string(reinterpret_cast<ptrdiff_t>(this)) + " - subscription: destroy - " + to_string(destructors.size()));
+            RX_TRACE(this, "subscription: destroy");
             {
-                auto expired = move(destructors);
-                for (auto& d : expired) {
-                    info(to_string(reinterpret_cast<ptrdiff_t>(this)) + " - subscription: destroy destructor");
-                    d();
-                    info(to_string(reinterpret_cast<ptrdiff_t>(this)) + " - subscription: destroy destructor exit");
+                // reverse order of make_state, the arena memory is released after
+                auto expired = destructors.close();
+                while (expired) {
+                    auto next = expired->next;
+                    RX_TRACE(this, "subscription: destroy destructor");
+                    expired->destroy(expired);
+                    RX_TRACE(this, "subscription: destroy destructor exit");
+                    expired = next;
+                }
+            }
+#if RX_LOCKFREE_SUBSCRIPTION
+            drain(stoppers.close(), [](stopper&){});
+            drain(scopes.close(), [](scope&){});
+#endif
+            RX_TRACE(this, "end lifetime");
+        }
+#if RX_LOCKFREE_SUBSCRIPTION
+        explicit shared(const shared_ptr<finish>& ) {
+            RX_TRACE(this, "new lifetime");
+        }
+        bool search_scopes(shared_ptr<shared> other) {
+            for(auto check = scopes.peek(); check; check = check->next) {
+                auto scope = check->w.lock();
+                if (scope == other) {
+                    return true;
                 }
+                if (scope && scope->search_scopes(other)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        void defer(function<void()> target) const {
+            // empty is immediate
+            auto d = atomic_load(&deferto);
+            if (d) {
+                (*d)(move(target));
+            } else {
+                target();
             }
-            info(to_string(reinterpret_cast<ptrdiff_t>(this)) + " - end lifetime");
         }
+        shared_ptr<const defer_type> deferto;
+        detail::atomic_stack<stopper> stoppers;
+        detail::atomic_stack<scope> scopes;
+#else
         explicit shared(const shared_ptr<finish>& ) 
-            : defer([](function<void()> target){target();}) {
-            info(to_string(reinterpret_cast<ptrdiff_t>(this)) + " - new lifetime");
+            : defer([](function<void()> target){target();})
+            , parents(0) {
+            RX_TRACE(this, "new lifetime");
+        }
+        /// guarded by the lock of this lifetime. 
+        /// no hooks are added once stopped.
+        hook* add_hook() {
+            return parents++ == 0 ? &nest : &*nests.emplace(nests.end());
+        }
+        /// removes this lifetime from each parent that is not stopped.
+        /// stopped parents keep their nested lifetimes for join.
+        void unnest() {
+            auto unlink = [](hook& h){
+                auto p = h.parent.lock();
+                if (!p) {
+                    return;
+                }
+                shared_ptr<shared> expired;
+                guard_type guard(p->lock);
+                if (p->stopped || !h.keep) {
+                    return;
+                }
+                p->unlink(&h);
+                expired = move(h.keep);
+            };
+            if (parents > 0) {
+                unlink(nest);
+            }
+            for (auto& h : nests) {
+                unlink(h);
+            }
         }
         bool search_scopes(shared_ptr<shared> other) {
             for(auto& check : scopes) {
@@ -62,10 +382,15 @@ private:
             }
             return false;
         }
-        function<void(function<void()>)> defer;
+        defer_type defer;
         list<function<void()>> stoppers;
-        list<function<void()>> destructors;
         list<weak_ptr<shared>> scopes;
+        size_t parents;
+        hook nest;
+        list<hook> nests;
+#endif
+        detail::atomic_stack<detail::state_record> destructors;
+        arena_type arena;
     };
 public:
     subscription() : signal(make_shared<finish>()), store(make_shared<shared>(signal)) {}
@@ -75,58 +400,147 @@ public:
     bool is_stopped() const {
         return !store || signal->stopped;
     }
+    /// \brief a cheaper poll for loops that produce values.
+    /// true as soon as this lifetime, or a lifetime that it is nested in, 
+    /// has been stopped, before the deferred stop reaches it.
+    /// \returns bool - if true stop producing. state may still be accessed.
+    bool stop_requested() const {
+        return signal->requested.load(memory_order_acquire);
+    }
     /// \brief 
     void insert(const subscription& s) const {
+#if RX_LOCKFREE_SUBSCRIPTION
+        if (is_stopped()) {
+            s.stop();
+            return;
+        }
+#else
         guard_type guard(signal->lock);
         if (is_stopped()) {
             s.stop();
             return;
         }
+#endif
         if (s == *this) {
-            info(to_string(reinterpret_cast<ptrdiff_t>(store.get())) + " - subscription: inserting self!");
+            RX_TRACE(store.get(), "subscription: inserting self!");
             std::abort();
         }
 
         if (store->search_scopes(s.store)) {
-            info(to_string(reinterpret_cast<ptrdiff_t>(store.get())) + " - subscription: inserting loop in lifetime!");
+            RX_TRACE(store.get(), "subscription: inserting loop in lifetime!");
             std::abort();
         }
 
+#if RX_LOCKFREE_SUBSCRIPTION
         // nest
-        signal->others.insert(s);
+        auto n = make_shared<nested>(s.store, s.signal);
+        n->keep = n;
+        if (!signal->others.push(n.get())) {
+            // stopped since the check above
+            n->keep.reset();
+            s.stop();
+            return;
+        }
+        ++signal->count;
+        atomic_thread_fence(memory_order_seq_cst);
+        if (signal->requested.load(memory_order_relaxed)) {
+            s.signal->request_stop();
+        }
 
-        weak_ptr<shared> p = store;
-        s.store->scopes.push_front(p);
+        s.store->scopes.push(new scope(store));
 
         // unnest when child is stopped
-        weak_ptr<shared> c = s.store;
-        s.insert([p, c, ps = signal, cs = s.signal](){
-            auto storep = p.lock();
-            auto storec = c.lock();
-            if (storep && storec) {
-                //info(to_string(reinterpret_cast<ptrdiff_t>(storep.get())) + " - subscription: erase nested - " + to_string(reinterpret_cast<ptrdiff_t>(storec.get())));
-                auto that = subscription(storep, ps);
-                auto s = subscription(storec, cs);
-                that.erase(s);
-            } else {
-                info("subscription: erase nested (store missing!)");
+        s.insert([w = weak_ptr<nested>(n), ps = signal](){
+            auto n = w.lock();
+            if (!n) {
+                return;
+            }
+            // request_nested reads signal under maintenance
+            ps->lock_maintenance();
+            auto claimed = n->claim(nested::erased);
+            ps->unlock_maintenance();
+            if (claimed) {
+                n->release();
+                ps->erase_one();
             }
         });
+#else
+        // nest. the child unlinks itself when it is stopped
+        {
+            guard_type nestedguard(s.signal->lock);
+            if (s.is_stopped()) {
+                return;
+            }
+            auto h = s.store->add_hook();
+            h->keep = s.store;
+            h->signal = s.signal;
+            h->parent = signal;
+            signal->link(h);
+        }
+        if (signal->requested) {
+            s.signal->request_stop();
+        }
+
+        weak_ptr<shared> p = store;
+        s.store->scopes.push_front(p);
+#endif
     }
     /// \brief 
     void erase(const subscription& s) const {
+#if RX_LOCKFREE_SUBSCRIPTION
+        if (is_stopped()) {
+            return;
+        }
+        if (s == *this) {
+            RX_TRACE("subscription: erasing self!");
+            std::abort();
+        }
+        shared_ptr<nested> found;
+        signal->lock_maintenance();
+        for (auto n = signal->others.peek(); n; n = n->next) {
+            if (n->key == s.store.get() && n->claim(nested::erased)) {
+                found = n->keep;
+                break;
+            }
+        }
+        signal->unlock_maintenance();
+        if (found) {
+            found->release();
+            signal->erase_one();
+        }
+#else
+        shared_ptr<shared> expired;
         guard_type guard(signal->lock);
         if (is_stopped()) {
             return;
         }
         if (s == *this) {
-            info("subscription: erasing self!");
+            RX_TRACE("subscription: erasing self!");
             std::abort();
         }
-        signal->others.erase(s);
+        for (auto h = signal->others; h; h = h->next) {
+            if (h->keep == s.store) {
+                signal->unlink(h);
+                expired = move(h->keep);
+                break;
+            }
+        }
+#endif
     }
     /// \brief 
     void insert(function<void()> stopper) const {
+#if RX_LOCKFREE_SUBSCRIPTION
+        if (is_stopped()) {
+            stopper();
+            return;
+        }
+
+        auto n = new subscription::stopper(move(stopper));
+        if (!store->stoppers.push(n)) {
+            unique_ptr<subscription::stopper> expired(n);
+            expired->f();
+        }
+#else
         guard_type guard(signal->lock);
 
         if (is_stopped()) {
@@ -136,6 +550,15 @@ public:
         }
 
         store->stoppers.emplace_front(stopper);
+#endif
+    }
+    /// \brief hint that about size bytes of state will be made.
+    /// the next chunk of the state arena is sized to fit.
+    void reserve(size_t size) const {
+        if (is_stopped()) {
+            return;
+        }
+        store->arena.reserve(size);
     }
     /// \brief 
     template<class Payload, class... ArgN>
@@ -149,14 +572,82 @@ public:
     state<Payload> copy_state(const state<Payload>&) const;
     /// \brief 
     void bind_defer(function<void(function<void()>)> d) {
+#if RX_LOCKFREE_SUBSCRIPTION
+        if (is_stopped()) {
+            return;
+        }
+        atomic_store(&store->deferto, shared_ptr<const defer_type>(make_shared<defer_type>(move(d))));
+#else
         guard_type guard(signal->lock);
         if (is_stopped()) {
             return;
         }
         store->defer = d;
+#endif
+    }
+#if RX_LOCKFREE_SUBSCRIPTION
+    /// \brief 
+    void stop() const {
+        if (is_stopped()) {
+            return;
+        }
+        // the nested lifetimes see the stop before the deferred sweep reaches them
+        signal->request_stop();
+        bool expected = false;
+        if (!signal->stopped.compare_exchange_strong(expected, true)) {
+            return;
+        }
+
+        auto st = move(store);
+        store = nullptr;
+
+        RX_TRACE(st.get(), "subscription: stopped set to true");
+
+        auto si = signal;
+
+        st->defer([=](){
+            RX_TRACE(st.get(), "subscription: stop");
+
+            // LIFO, the same order as the locked stoppers list
+            drain(st->stoppers.close(), [&](stopper& s){
+                RX_TRACE(st.get(), "subscription: stop stopper");
+                s.f();
+                RX_TRACE(st.get(), "subscription: stop stopper exit");
+            });
+
+            si->lock_maintenance();
+            auto swept = si->others.close();
+            for (auto n = swept; n; n = n->next) {
+                n->claim(nested::swept);
+            }
+            si->swept = swept;
+            si->unlock_maintenance();
+
+            // the closed chain is only released by ~finish
+            for (auto n = swept; n; n = n->next) {
+                if (n->status == nested::swept) {
+                    RX_TRACE(st.get(), "subscription: stop other");
+                    si->join_one(n->signal);
+                    subscription(n->store, n->signal).stop();
+                    RX_TRACE(st.get(), "subscription: stop other exit");
+                }
+            }
+
+            atomic_store(&st->deferto, shared_ptr<const defer_type>());
+
+            RX_TRACE(st.get(), "subscription: release join");
+            si->release_one();
+            RX_TRACE(st.get(), "subscription: stopped");
+        });
     }
+#else
     /// \brief 
     void stop() const {
+        if (is_stopped()) {
+            return;
+        }
+        // the nested lifetimes see the stop before the deferred sweep reaches them
+        signal->request_stop();
         guard_type guard(signal->lock);
         if (is_stopped()) {
             return;
@@ -166,33 +657,33 @@ public:
         store = nullptr;
 
         signal->stopped = true;
-        info(to_string(reinterpret_cast<ptrdiff_t>(st.get())) + " - subscription: stopped set to true");
+        RX_TRACE(st.get(), "subscription: stopped set to true");
 
         auto si = signal;
 
         guard.unlock();
 
         st->defer([=](){
-            info(to_string(reinterpret_cast<ptrdiff_t>(st.get())) + " - subscription: stop");
+            RX_TRACE(st.get(), "subscription: stop");
 
             {
                 guard_type guard(si->lock);
                 auto expired = st->stoppers;
                 guard.unlock();
                 for (auto s : expired) {
-                    info(to_string(reinterpret_cast<ptrdiff_t>(st.get())) + " - subscription: stop stopper");
+                    RX_TRACE(st.get(), "subscription: stop stopper");
                     s();
-                    info(to_string(reinterpret_cast<ptrdiff_t>(st.get())) + " - subscription: stop stopper exit");
+                    RX_TRACE(st.get(), "subscription: stop stopper exit");
                 }
             }
+            st->unnest();
             {
-                guard_type guard(si->lock);
-                auto expired = si->others;
-                guard.unlock();
-                for (auto o : expired) {
-                    info(to_string(reinterpret_cast<ptrdiff_t>(st.get())) + " - subscription: stop other");
-                    o.stop();
-                    info(to_string(reinterpret_cast<ptrdiff_t>(st.get())) + " - subscription: stop other exit");
+                // once stopped, others does not change
+                for (auto h = si->others; h; h = h->next) {
+                    RX_TRACE(st.get(), "subscription: stop other");
+                    si->join_one(h->signal);
+                    subscription(h->keep, h->signal).stop();
+                    RX_TRACE(st.get(), "subscription: stop other exit");
                 }
             }
             {
@@ -201,33 +692,63 @@ public:
                 st->stoppers.clear();
             }
 
-            info(to_string(reinterpret_cast<ptrdiff_t>(st.get())) + " - subscription: notify_all");
-            {
-                unique_lock<mutex> guard(si->joinlock);
-                si->joined = true;
-            }
-            si->joinwake.notify_all();
-            info(to_string(reinterpret_cast<ptrdiff_t>(st.get())) + " - subscription: stopped");
+            RX_TRACE(st.get(), "subscription: release join");
+            si->release_one();
+            RX_TRACE(st.get(), "subscription: stopped");
         });
     }
-    /// \brief
-    void join() const {
-        info(to_string(reinterpret_cast<ptrdiff_t>(store.get())) + " - subscription: join");
-        {
-            unique_lock<mutex> guard(signal->lock);
-            auto expired = signal->others;
-            guard.unlock();
-            for (auto o : expired) {
-                info(to_string(reinterpret_cast<ptrdiff_t>(store.get())) + " - subscription: join other");
-                o.join();
-                info(to_string(reinterpret_cast<ptrdiff_t>(store.get())) + " - subscription: join other exit");
+#endif
+    /// \brief adds n to the demand of this lifetime. the first request opts in, 
+    /// after which the producers that honor demand send at most the requested 
+    /// number of values.
+    void request(size_t n) const {
+        auto d = demand();
+        if (!d) {
+            auto created = make_shared<detail::demand>();
+            if (atomic_compare_exchange_strong(&signal->demand, &d, created)) {
+                d = created;
+                // releases the parked producers
+                insert([created](){
+                    created->close();
+                });
             }
         }
-        {
-            unique_lock<mutex> guard(signal->joinlock);
-            signal->joinwake.wait(guard, [s = this->signal](){return !!s->joined;});
-        }
-        info(to_string(reinterpret_cast<ptrdiff_t>(store.get())) + " - subscription: joined " + (signal->joined ? "true" : "false"));
+        d->request(n);
+    }
+    /// \returns the demand of this lifetime or nullptr when it has not opted in
+    shared_ptr<detail::demand> demand() const {
+        return atomic_load(&signal->demand);
+    }
+    /// \brief shares the demand d with this lifetime
+    void bind_demand(shared_ptr<detail::demand> d) const {
+        atomic_store(&signal->demand, move(d));
+    }
+    /// \brief calls f once this lifetime and the nested lifetimes that 
+    /// its stop swept have all finished stopping. does not block. 
+    /// the sweep reaches the lifetimes that are still nested when it runs. 
+    /// a lifetime erased before then is not waited for, even when it was 
+    /// nested at the time of this call.
+    /// f may be called on the thread that finishes the last stop or, 
+    /// when that has already happened, from on_joined.
+    void on_joined(function<void()> f) const {
+        signal->on_joined(move(f));
+    }
+    /// \returns a future that is ready once on_joined would call back.
+    future<void> joined() const {
+        auto p = make_shared<promise<void>>();
+        auto result = p->get_future();
+        on_joined([p](){
+            p->set_value();
+        });
+        return result;
+    }
+    /// \brief blocks until the stop of this lifetime and the nested 
+    /// lifetimes that it swept have finished. see on_joined for the 
+    /// lifetimes that are waited for.
+    void join() const {
+        RX_TRACE(store.get(), "subscription: join");
+        joined().wait();
+        RX_TRACE(store.get(), "subscription: joined");
     }
     shared_ptr<finish> signal;
     mutable shared_ptr<shared> store;
@@ -297,26 +818,17 @@ public:
 
 template<class Payload, class... ArgN>
 state<Payload> subscription::make_state(ArgN&&... argn) const {
-    guard_type guard(signal->lock);
-    auto size = store->destructors.size();
-    info(to_string(reinterpret_cast<ptrdiff_t>(store.get())) + " - subscription: make_state - " + to_string(size) + " " + typeid(Payload).name());
+    RX_TRACE(store.get(), "subscription: make_state", typeid(Payload).name());
     if (is_stopped()) {
         throw lifetime_error("subscription is stopped!");
     }
-    auto p = make_unique<Payload>(forward<ArgN>(argn)...);
-    auto result = state<Payload>{*this, p.get()};
-    store->destructors.emplace_front(
-        [d=p.release(), s=store.get(), size]() mutable {
-            info(to_string(reinterpret_cast<ptrdiff_t>(s)) + " - subscription: destroy make_state - " + to_string(size) + " " + typeid(Payload).name());
-            auto p = d; 
-            d = nullptr; 
-            delete p;
-            info(to_string(reinterpret_cast<ptrdiff_t>(s)) + " - subscription: destroy make_state exit - " + to_string(size) + " " + typeid(Payload).name());
-        });
-    return result;
+    // one bump in the arena holds the payload and the record that destroys it
+    auto r = store->arena.template make<Payload>(forward<ArgN>(argn)...);
+    store->destructors.push(r);
+    return state<Payload>{*this, addressof(r->value)};
 }
 state<> subscription::make_state() const {
-    info(to_string(reinterpret_cast<ptrdiff_t>(store.get())) + " - subscription: make_state");
+    RX_TRACE(store.get(), "subscription: make_state");
     if (is_stopped()) {
         throw lifetime_error("subscription is stopped!");
     }
@@ -0,0 +1,134 @@
+#pragma once
+
+///
+/// RX_TRACE(what)
+/// RX_TRACE(object, what)
+/// RX_TRACE(object, what, value)
+///
+/// what must be a string literal. object is the address that the event is about.
+/// value is an integral, a pointer or a string with static storage (typeid().name()).
+///
+/// RX_INFO=0 compiles every trace out. the arguments are not evaluated.
+/// RX_INFO=1 formats each trace as text and passes it to the info() provided by the app.
+/// RX_INFO=2 records each trace as a fixed size binary event in a ring buffer.
+///           nothing is formatted until rx::trace::dump() is called.
+///
+#if RX_INFO == 2
+#define RX_TRACE(...) ::rx::trace::record(__VA_ARGS__)
+#elif RX_INFO
+#define RX_TRACE(...) ::info(::rx::trace::format(__VA_ARGS__))
+#else
+#define RX_TRACE(...) ((void)0)
+#endif
+
+namespace rx {
+
+namespace trace {
+
+struct event
+{
+    steady_clock::time_point at;
+    thread::id id;
+    const char* what;
+    const void* object;
+    intptr_t value;
+    const char* detail;
+};
+
+namespace detail {
+    inline intptr_t to_value(const void* v) {
+        return reinterpret_cast<intptr_t>(v);
+    }
+    template<class V, class C = enable_if_t<is_integral<V>::value || is_enum<V>::value>>
+    intptr_t to_value(V v) {
+        return static_cast<intptr_t>(v);
+    }
+
+    /// the most recent events are kept. older events are overwritten.
+    struct ring
+    {
+        static const size_t capacity = 1 << 16;
+        ring() : next(0) {}
+        atomic<size_t> next;
+        event events[capacity];
+    };
+    inline ring& events() {
+        static ring r;
+        return r;
+    }
+    inline void push(const void* object, const char* what, intptr_t value, const char* detail) {
+        auto& r = events();
+        auto i = r.next.fetch_add(1, memory_order_relaxed);
+        r.events[i % ring::capacity] = event{steady_clock::now(), this_thread::get_id(), what, object, value, detail};
+    }
+}
+
+inline void record(const char* what) {
+    detail::push(nullptr, what, 0, nullptr);
+}
+inline void record(const void* object, const char* what) {
+    detail::push(object, what, 0, nullptr);
+}
+inline void record(const void* object, const char* what, const char* detail) {
+    detail::push(object, what, 0, detail);
+}
+template<class V>
+void record(const void* object, const char* what, V value) {
+    detail::push(object, what, detail::to_value(value), nullptr);
+}
+
+inline string format(const event& e) {
+    string result;
+    if (e.object) {
+        result += to_string(reinterpret_cast<ptrdiff_t>(e.object)) + " - ";
+    }
+    result += e.what;
+    if (e.detail) {
+        result += string(" - ") + e.detail;
+    } else if (e.value) {
+        result += " - " + to_string(e.value);
+    }
+    return result;
+}
+inline string format(const char* what) {
+    return format(event{{}, {}, what, nullptr, 0, nullptr});
+}
+inline string format(const void* object, const char* what) {
+    return format(event{{}, {}, what, object, 0, nullptr});
+}
+inline string format(const void* object, const char* what, const char* detail) {
+    return format(event{{}, {}, what, object, 0, detail});
+}
+template<class V>
+string format(const void* object, const char* what, V value) {
+    return format(event{{}, {}, what, object, detail::to_value(value), nullptr});
+}
+
+/// \brief calls f with each recorded event, oldest first.
+/// events recorded while this runs may be torn.
+template<class F>
+void for_each(F&& f) {
+    auto& r = detail::events();
+    auto last = r.next.load(memory_order_acquire);
+    auto first = last > detail::ring::capacity ? last - detail::ring::capacity : 0;
+    for (auto i = first; i != last; ++i) {
+        f(r.events[i % detail::ring::capacity]);
+    }
+}
+
+/// \brief writes the recorded events as text
+inline void dump(ostream& output) {
+    bool first = true;
+    steady_clock::time_point origin;
+    for_each([&](const event& e){
+        if (first) {
+            origin = e.at;
+            first = false;
+        }
+        output << e.id << " - " << fixed << setprecision(3) << setw(8) << duration<double>(e.at - origin).count() << "s - " << format(e) << endl;
+    });
+}
+
+}
+
+}
@@ -57,5 +57,32 @@ using clock_time_point_t = time_point_t<clock_t<T>>;
 template<class T>
 using clock_duration_t = duration_t<clock_t<T>>;
 
+/// a view of count contiguous values
+template<class T>
+struct span {
+    span(T* first, size_t count) : p(first), count(count) {}
+    template<class U, class CheckU = enable_if_t<is_convertible<U*, T*>::value>>
+    span(const span<U>& o) : p(o.begin()), count(o.size()) {}
+    T* begin() const {
+        return p;
+    }
+    T* end() const {
+        return p + count;
+    }
+    size_t size() const {
+        return count;
+    }
+    T& operator[](size_t i) const {
+        return p[i];
+    }
+    /// \returns the first n values
+    span first(size_t n) const {
+        return {p, n < count ? n : count};
+    }
+private:
+    T* p;
+    size_t count;
+};
+
 
 }
@@ -2,6 +2,70 @@
 
 namespace rx {
 
+///
+/// \brief the cpus that a thread may run on. empty is any cpu.
+///
+struct thread_affinity
+{
+    vector<unsigned> cpus;
+
+    bool empty() const {
+        return cpus.empty();
+    }
+
+    /// \returns the cpus of numa node n. empty when the node is not known.
+    static thread_affinity numa_node(unsigned n) {
+        thread_affinity result;
+#if defined(__linux__)
+        // a list of ranges, "0-3,8-11"
+        ifstream list("/sys/devices/system/node/node" + to_string(n) + "/cpulist");
+        string range;
+        while (getline(list, range, ',')) {
+            istringstream r(range);
+            unsigned first = 0;
+            char dash = 0;
+            if (!(r >> first)) {
+                continue;
+            }
+            auto last = first;
+            r >> dash >> last;
+            for (auto cpu = first; cpu <= last; ++cpu) {
+                result.cpus.push_back(cpu);
+            }
+        }
+#else
+        (void)n;
+#endif
+        return result;
+    }
+};
+
+namespace detail {
+
+/// \brief restricts the calling thread to the cpus. does nothing when 
+/// the affinity is empty or the platform does not support it.
+inline void pin_this_thread(const thread_affinity& a) {
+#if defined(__linux__)
+    if (a.empty()) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : a.cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        RX_TRACE("new_thread: pin failed");
+    }
+#else
+    (void)a;
+#endif
+}
+
+}
+
 struct threadjoin
 {
     thread worker;
@@ -13,7 +77,7 @@ struct threadjoin
         worker.detach();
     }
     ~threadjoin(){
-        info("threadjoin: destroy notify");
+        RX_TRACE("threadjoin: destroy notify");
         notify();
     }
     
@@ -26,36 +90,99 @@ struct new_thread {
     subscription lifetime;
     strand_type strand;
     state<threadjoin> worker;
+    /// the cpus that the thread is pinned to
+    thread_affinity affinity;
     
-    new_thread(strand_type&& s, state<threadjoin>&& t) 
+    new_thread(strand_type&& s, state<threadjoin>&& t, thread_affinity a) 
         : lifetime(s.lifetime)
         , strand(move(s))
-        , worker(move(t)) {
+        , worker(move(t))
+        , affinity(move(a)) {
     }
     
     template<class At, class... ON>
     void operator()(At at, observer<ON...> out) const {
-        strand.defer_at(at, out);
+        strand.defer_at(at, move(out));
     }
 };
 
-template<class Clock = steady_clock, class Error = exception_ptr>
+template<class Clock = steady_clock, class Error = exception_ptr, class Queue = observe_at_heap>
 struct make_new_thread {
+    using loop_type = run_loop<Clock, Error, Queue>;
+
+    /// the cpus that each new thread is pinned to. empty is any cpu
+    thread_affinity affinity;
+
     auto operator()(subscription lifetime) const {
-        info("new_thread: create");
-        run_loop<Clock, Error> loop(subscription{});
+        RX_TRACE("new_thread: create");
+        thread worker;
+        auto loop = start(worker);
         auto strand = loop.make()(lifetime);
-        auto t = make_state<threadjoin>(lifetime, [=](){
-                info("new_thread: loop run enter");
-                loop.run();
-                info("new_thread: loop run exit");
-            }, [l = loop.lifetime](){
-                info("new_thread: loop stop enter");
+        auto t = make_state<threadjoin>(lifetime, move(worker), [l = loop.lifetime](){
+                RX_TRACE("new_thread: loop stop enter");
                 l.stop();
-                info("new_thread: loop stop exit");
+                RX_TRACE("new_thread: loop stop exit");
             });
-        return make_strand<Clock>(lifetime, new_thread<decltype(strand)>(move(strand), move(t)), detail::now<Clock>{});
+        return make_strand<Clock>(lifetime, new_thread<decltype(strand)>(move(strand), move(t), affinity), detail::now<Clock>{});
+    }
+
+    /// \returns a copy that, unless it is already pinned, pins its threads to the cpus of other
+    template<class Other>
+    make_new_thread near(const Other& other) const;
+
+private:
+    loop_type start(thread& worker) const {
+        if (affinity.empty()) {
+            loop_type loop(subscription{});
+            worker = thread([=](){
+                RX_TRACE("new_thread: loop run enter");
+                loop.run();
+                RX_TRACE("new_thread: loop run exit");
+            });
+            return loop;
+        }
+        // the loop is made on the pinned thread, so that its memory is local to the cpus
+        promise<loop_type> made;
+        auto loop = made.get_future();
+        worker = thread([a = affinity, made = move(made)]() mutable {
+            detail::pin_this_thread(a);
+            loop_type pinned(subscription{});
+            made.set_value(pinned);
+            RX_TRACE("new_thread: loop run enter");
+            pinned.run();
+            RX_TRACE("new_thread: loop run exit");
+        });
+        return loop.get();
     }
 };
 
-}
\ No newline at end of file
+namespace detail {
+
+/// \returns the cpus that the strands of m are pinned to. empty when m does not pin them.
+template<class MakeStrand>
+auto affinity_of(const MakeStrand& m, int) -> decltype(thread_affinity(m.affinity)) {
+    return m.affinity;
+}
+template<class MakeStrand>
+thread_affinity affinity_of(const MakeStrand&, ...) {
+    return {};
+}
+/// \returns the cpus that the thread of strand s is pinned to
+template<class Execute, class Now, class Clock>
+thread_affinity affinity_of(const strand<Execute, Now, Clock>& s, int) {
+    return affinity_of(s.e, 0);
+}
+
+}
+
+template<class Clock, class Error, class Queue>
+template<class Other>
+make_new_thread<Clock, Error, Queue> make_new_thread<Clock, Error, Queue>::near(const Other& other) const {
+    auto result = *this;
+    if (result.affinity.empty()) {
+        result.affinity = detail::affinity_of(other, 0);
+    }
+    return result;
+}
+
+}
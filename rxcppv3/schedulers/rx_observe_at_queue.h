@@ -24,6 +24,9 @@ struct observe_at<Clock, observer<ON...>>
 // Sorts observe_at items in priority order sorted
 // on value of observe_at.when. Items with equal
 // values for when are sorted in fifo order.
+//
+// The items are held in recycled nodes and the heap only
+// moves trivially copyable entries that point at them.
 
 template<class Clock, class Observer>
 class observe_at_queue;
@@ -34,19 +37,35 @@ public:
     using clock_type = decay_t<Clock>;
     using observer_type = observer<ON...>;
     using item_type = observe_at<clock_type, observer_type>;
-    using elem_type = std::pair<item_type, int64_t>;
-    using container_type = std::vector<elem_type>;
     using const_reference = const item_type&;
 
 private:
+    struct node
+    {
+        typename aligned_storage<sizeof(item_type), alignof(item_type)>::type storage;
+        node* next;
+
+        item_type& item() {
+            return *reinterpret_cast<item_type*>(&storage);
+        }
+    };
+
+    struct elem_type
+    {
+        time_point<clock_type> when;
+        int64_t ordinal;
+        node* n;
+    };
+    using container_type = std::vector<elem_type>;
+
     struct compare_elem
     {
         bool operator()(const elem_type& lhs, const elem_type& rhs) const {
-            if (lhs.first.when == rhs.first.when) {
-                return lhs.second > rhs.second;
+            if (lhs.when == rhs.when) {
+                return lhs.ordinal > rhs.ordinal;
             }
             else {
-                return lhs.first.when > rhs.first.when;
+                return lhs.when > rhs.when;
             }
         }
     };
@@ -60,13 +79,60 @@ private:
     queue_type q;
 
     int64_t ordinal;
+
+    // nodes that do not hold an item
+    node* free;
+
+    template<class Item>
+    void emplace(Item&& value) {
+        node* n = free;
+        if (n) {
+            free = n->next;
+        } else {
+            n = new node;
+        }
+        new (&n->storage) item_type(std::forward<Item>(value));
+        q.push(elem_type{n->item().when, ordinal++, n});
+    }
+
+    void recycle(node* n) {
+        n->item().~item_type();
+        n->next = free;
+        free = n;
+    }
+
 public:
+    observe_at_queue() : ordinal(0), free(nullptr) {}
+    observe_at_queue(const observe_at_queue&) = delete;
+    observe_at_queue& operator=(const observe_at_queue&) = delete;
+    ~observe_at_queue() {
+        while (!q.empty()) {
+            pop();
+        }
+        while (free) {
+            auto n = free;
+            free = free->next;
+            delete n;
+        }
+    }
+
     const_reference top() const {
-        return q.top().first;
+        return q.top().n->item();
     }
 
     void pop() {
+        auto n = q.top().n;
+        q.pop();
+        recycle(n);
+    }
+
+    /// \brief removes the top item and moves it out.
+    item_type take() {
+        auto n = q.top().n;
         q.pop();
+        item_type result(std::move(n->item()));
+        recycle(n);
+        return result;
     }
 
     bool empty() const {
@@ -74,11 +140,11 @@ public:
     }
 
     void push(const item_type& value) {
-        q.push(elem_type(value, ordinal++));
+        emplace(value);
     }
 
     void push(item_type&& value) {
-        q.push(elem_type(std::move(value), ordinal++));
+        emplace(std::move(value));
     }
 };
 
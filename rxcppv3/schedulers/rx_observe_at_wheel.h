@@ -0,0 +1,269 @@
+#pragma once
+
+namespace rx {
+
+namespace detail {
+
+inline int wheel_highest_bit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#else
+    int r = 0;
+    while (x >>= 1) ++r;
+    return r;
+#endif
+}
+
+inline int wheel_lowest_bit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int r = 0;
+    while (!(x & 1)) { x >>= 1; ++r; }
+    return r;
+#endif
+}
+
+}
+
+// Hierarchical timing wheel with the same interface as observe_at_queue.
+//
+// Time is divided into ticks of Resolution. Each level has 64 slots and
+// each level covers 64 times the span of the level below, so 11 levels
+// cover every 64-bit tick and there is no overflow list. An item is
+// placed at the level of the highest 6-bit digit in which its tick
+// differs from the current tick, which is the tick of the last item popped.
+// Occupied slots are tracked in a bitmask per level so that finding the
+// next slot is a bit scan.
+//
+// push is O(1). Level 0 holds exact ticks, so top() and pop() are O(1)
+// while it has items. Otherwise the earliest item is found by scanning the
+// first occupied slot of the lowest occupied level and pop() cascades the
+// rest of that slot to the levels below. Each item cascades at most once
+// per level, so pop() is O(1) amortized.
+//
+// Items with the same tick are kept in fifo order. Unlike observe_at_queue,
+// items in the same tick are not sorted by when, and items pushed with a
+// tick before the last item popped are treated as due in that tick.
+// Nodes are recycled, so a steady state of push/pop does not allocate.
+
+template<class Clock, class Observer, class Resolution = milliseconds>
+class observe_at_wheel;
+
+template<class Clock, class... ON, class Resolution>
+class observe_at_wheel<Clock, observer<ON...>, Resolution> {
+public:
+    using clock_type = decay_t<Clock>;
+    using observer_type = observer<ON...>;
+    using item_type = observe_at<clock_type, observer_type>;
+    using const_reference = const item_type&;
+
+private:
+    static const int bits = 6;
+    static const int slots = 1 << bits;
+    static const int levels = (64 + bits - 1) / bits;
+
+    struct node
+    {
+        typename aligned_storage<sizeof(item_type), alignof(item_type)>::type storage;
+        uint64_t tick;
+        node* next;
+
+        item_type& item() {
+            return *reinterpret_cast<item_type*>(&storage);
+        }
+        const item_type& item() const {
+            return *reinterpret_cast<const item_type*>(&storage);
+        }
+    };
+
+    struct slot
+    {
+        node* head = nullptr;
+        node* tail = nullptr;
+    };
+
+    slot wheel[levels][slots];
+    uint64_t occupied[levels];
+    uint64_t current;
+    size_t count;
+    // nodes that do not hold an item
+    node* free;
+    // cache of the earliest item while level 0 is empty
+    mutable node* earliest;
+
+    static uint64_t to_tick(time_point<clock_type> when) {
+        auto t = duration_cast<Resolution>(when.time_since_epoch()).count();
+        return t < 0 ? 0 : static_cast<uint64_t>(t);
+    }
+
+    static int index(uint64_t tick, int level) {
+        return static_cast<int>((tick >> (level * bits)) & (slots - 1));
+    }
+
+    void link(node* n) {
+        n->tick = max(n->tick, current);
+        auto diff = n->tick ^ current;
+        auto level = diff == 0 ? 0 : detail::wheel_highest_bit(diff) / bits;
+        auto i = index(n->tick, level);
+        auto& s = wheel[level][i];
+        n->next = nullptr;
+        if (s.tail) {
+            s.tail->next = n;
+        } else {
+            s.head = n;
+            occupied[level] |= uint64_t(1) << i;
+        }
+        s.tail = n;
+    }
+
+    slot& first_slot(int level) const {
+        return const_cast<slot&>(wheel[level][detail::wheel_lowest_bit(occupied[level])]);
+    }
+
+    int lowest_level() const {
+        int level = 0;
+        while (occupied[level] == 0) ++level;
+        return level;
+    }
+
+    node* find_earliest() const {
+        if (!earliest) {
+            auto n = first_slot(lowest_level()).head;
+            earliest = n;
+            for (n = n->next; n; n = n->next) {
+                if (n->tick < earliest->tick) {
+                    earliest = n;
+                }
+            }
+        }
+        return earliest;
+    }
+
+    template<class Item>
+    void emplace(Item&& value) {
+        node* n = free;
+        if (n) {
+            free = n->next;
+        } else {
+            n = new node;
+        }
+        new (&n->storage) item_type(forward<Item>(value));
+        n->tick = to_tick(n->item().when);
+        link(n);
+        if (earliest && n->tick < earliest->tick) {
+            earliest = n;
+        }
+        ++count;
+    }
+
+public:
+    observe_at_wheel()
+        : occupied{}
+        , current(0)
+        , count(0)
+        , free(nullptr)
+        , earliest(nullptr) {
+    }
+    observe_at_wheel(const observe_at_wheel&) = delete;
+    observe_at_wheel& operator=(const observe_at_wheel&) = delete;
+    ~observe_at_wheel() {
+        for (auto& level : wheel) {
+            for (auto& s : level) {
+                while (s.head) {
+                    auto n = s.head;
+                    s.head = n->next;
+                    n->item().~item_type();
+                    delete n;
+                }
+            }
+        }
+        while (free) {
+            auto n = free;
+            free = free->next;
+            delete n;
+        }
+    }
+
+    const_reference top() const {
+        if (occupied[0]) {
+            return first_slot(0).head->item();
+        }
+        return find_earliest()->item();
+    }
+
+    void pop() {
+        node* n = nullptr;
+        if (occupied[0]) {
+            auto& s = first_slot(0);
+            n = s.head;
+            s.head = n->next;
+            if (!s.head) {
+                s.tail = nullptr;
+                occupied[0] &= ~(uint64_t(1) << index(n->tick, 0));
+            }
+            current = n->tick;
+            if (n == earliest) {
+                earliest = nullptr;
+            }
+        } else {
+            n = find_earliest();
+            earliest = nullptr;
+
+            // advance to the earliest item and cascade the rest of its slot
+            auto level = lowest_level();
+            auto& s = first_slot(level);
+            auto rest = s.head;
+            s.head = s.tail = nullptr;
+            occupied[level] &= ~(uint64_t(1) << index(n->tick, level));
+            current = n->tick;
+            while (rest) {
+                auto next = rest->next;
+                if (rest != n) {
+                    link(rest);
+                }
+                rest = next;
+            }
+        }
+        --count;
+        n->item().~item_type();
+        n->next = free;
+        free = n;
+    }
+
+    /// \brief removes the top item and moves it out.
+    item_type take() {
+        item_type result(move(const_cast<item_type&>(top())));
+        pop();
+        return result;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void push(const item_type& value) {
+        emplace(value);
+    }
+
+    void push(item_type&& value) {
+        emplace(move(value));
+    }
+};
+
+// queue policies for run_loop
+
+struct observe_at_heap
+{
+    template<class Clock, class Observer>
+    using queue = observe_at_queue<Clock, Observer>;
+};
+
+template<class Resolution = milliseconds>
+struct observe_at_timer_wheel
+{
+    template<class Clock, class Observer>
+    using queue = observe_at_wheel<Clock, Observer, Resolution>;
+};
+
+}
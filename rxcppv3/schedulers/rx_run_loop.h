@@ -2,23 +2,29 @@
 
 namespace rx {
 
-template<class Clock = steady_clock, class Error = exception_ptr>
+/// Queue selects the container for deferred items.
+/// observe_at_heap is a priority queue, observe_at_timer_wheel<Resolution> is a timing wheel.
+template<class Clock = steady_clock, class Error = exception_ptr, class Queue = observe_at_heap>
 struct run_loop {
     using clock_type = decay_t<Clock>;
     using error_type = decay_t<Error>;
+    using queue_policy = decay_t<Queue>;
     using lock_type = mutex;
     using guard_type = unique_lock<lock_type>;
     using observer_type = observer_interface<detail::re_defer_at_t<clock_type>, error_type>;
     using item_type = observe_at<clock_type, observer_type>;
-    using queue_type = observe_at_queue<clock_type, observer_type>;
+    using queue_type = typename queue_policy::template queue<clock_type, observer_type>;
 
     struct guarded_loop {
+        guarded_loop() : sweep(make_shared<detail::stop_sweep>()) {}
         ~guarded_loop() {
-            info(to_string(reinterpret_cast<ptrdiff_t>(this)) + " - run_loop: guarded_loop destroy");
+            RX_TRACE(this, "run_loop: guarded_loop destroy");
         }
         lock_type lock;
         condition_variable wake;
         queue_type deferred;
+        /// the stops deferred to any strand of the loop are swept together
+        shared_ptr<detail::stop_sweep> sweep;
     };
 
     subscription lifetime;
@@ -29,18 +35,18 @@ struct run_loop {
         , loop(make_state<guarded_loop>(lifetime)) {
         auto& guarded = this->loop.get();
         lifetime.insert([&guarded](){
-            info(to_string(reinterpret_cast<ptrdiff_t>(addressof(guarded))) + " - run_loop: stop notify_all");
+            RX_TRACE(addressof(guarded), "run_loop: stop notify_all");
             //guard_type guard(guarded.lock);
             guarded.wake.notify_all();
         });
     }
     ~run_loop(){
-        info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: destroy");
+        RX_TRACE(addressof(loop.get()), "run_loop: destroy");
     }
     
     bool is_ready(guard_type& guard) const {
         if (!guard.owns_lock()) { 
-            info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: is_ready caller must own lock!");
+            RX_TRACE(addressof(loop.get()), "run_loop: is_ready caller must own lock!");
             abort(); 
         }
         auto& deferred = loop.get().deferred;
@@ -49,81 +55,110 @@ struct run_loop {
 
     bool wait(guard_type& guard) const {
         if (!guard.owns_lock()) { 
-            info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: wait caller must own lock!");
+            RX_TRACE(addressof(loop.get()), "run_loop: wait caller must own lock!");
             abort(); 
         }
         auto& deferred = loop.get().deferred;
-        info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: wait");
+        RX_TRACE(addressof(loop.get()), "run_loop: wait");
         if (!loop.lifetime.is_stopped()) {
             if (!deferred.empty()) {
-                info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: wait_until top when");
+                RX_TRACE(addressof(loop.get()), "run_loop: wait_until top when");
                 loop.get().wake.wait_until(guard, deferred.top().when, [&](){
                     bool r = is_ready(guard) || loop.lifetime.is_stopped();
-                    info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: wait wakeup is_ready - " + to_string(r));
+                    RX_TRACE(addressof(loop.get()), "run_loop: wait wakeup is_ready", r ? "true" : "false");
                     return r;
                 });
             } else {
-                info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: wait for notify");
+                RX_TRACE(addressof(loop.get()), "run_loop: wait for notify");
                 loop.get().wake.wait(guard, [&](){
                     bool r = !deferred.empty() || loop.lifetime.is_stopped();
-                    info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: wait wakeup is_ready - " + to_string(r));
+                    RX_TRACE(addressof(loop.get()), "run_loop: wait wakeup is_ready", r ? "true" : "false");
                     return r;
                 });
             }
         }
-        info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: wake");
+        RX_TRACE(addressof(loop.get()), "run_loop: wake");
         return !loop.lifetime.is_stopped();
     }
 
-    void call(guard_type& guard, item_type& next) const {
-        if (guard.owns_lock()) { 
-            info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: call caller must not own lock!");
-            abort(); 
-        }
-        info("run_loop: call");
-        auto& deferred = loop.get().deferred;
+    /// \returns true when next re-deferred itself. the caller must push it again.
+    bool call(item_type& next) const {
+        RX_TRACE("run_loop: call");
         bool complete = true;
         next.what.next([&](time_point<clock_type> at){
-            unique_lock<guard_type> nestedguard(guard);
-            info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: call self");
+            RX_TRACE(addressof(loop.get()), "run_loop: call self");
             if (lifetime.is_stopped() || next.what.lifetime.is_stopped()) return;
-            info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: call push self");
+            RX_TRACE(addressof(loop.get()), "run_loop: call push self");
             next.when = at;
-            deferred.push(next);
             complete = false;
         });
         if (complete) {
-            info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: call complete");
+            RX_TRACE(addressof(loop.get()), "run_loop: call complete");
             next.what.complete();
         }
+        return !complete;
     }
 
+    /// \brief runs the ready items in batches.
+    /// each batch takes every ready item under one lock, runs them without the lock 
+    /// and then pushes the items that re-deferred themselves under one lock.
     void step(guard_type& guard, typename clock_type::duration d) const {
         if (!guard.owns_lock()) { 
-            info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: step caller must own lock!");
+            RX_TRACE(addressof(loop.get()), "run_loop: step caller must own lock!");
             abort(); 
         }
         auto& deferred = loop.get().deferred;
-        auto stop = clock_type::now() + d;
-        while (!loop.lifetime.is_stopped() && is_ready(guard) && clock_type::now() < stop) {
-            info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: step");
 
-            auto next = move(deferred.top());
-            deferred.pop();
-            
+        // the scratch buffer is moved out while in use so that 
+        // a nested step on this thread will use a different buffer
+        static thread_local vector<item_type> scratch;
+        auto batch = move(scratch);
+
+        auto now = clock_type::now();
+        auto stop = now + d;
+        while (!loop.lifetime.is_stopped() && now < stop) {
+            while (!deferred.empty() && deferred.top().when <= now) {
+                batch.push_back(deferred.take());
+            }
+            if (batch.empty()) {
+                break;
+            }
+            RX_TRACE(addressof(loop.get()), "run_loop: step", batch.size());
+
             guard.unlock();
-            call(guard, next);
+            size_t kept = 0;
+            for (auto& next : batch) {
+                // items are kept in the queue when the loop stops
+                if (loop.lifetime.is_stopped() || call(next)) {
+                    if (addressof(batch[kept]) != addressof(next)) {
+                        batch[kept] = move(next);
+                    }
+                    ++kept;
+                } else {
+                    // release the observer now instead of with the batch
+                    item_type done(move(next));
+                }
+            }
+            batch.erase(batch.begin() + kept, batch.end());
             guard.lock();
+
+            for (auto& next : batch) {
+                deferred.push(move(next));
+            }
+            batch.clear();
+            now = clock_type::now();
         }
+
+        scratch = move(batch);
     }
     
     void run() const {
         guard_type guard(loop.get().lock);
-        info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: run");
+        RX_TRACE(addressof(loop.get()), "run_loop: run");
         while (wait(guard)) {
             step(guard, 3600s);
         }
-        info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: exit");
+        RX_TRACE(addressof(loop.get()), "run_loop: exit");
     }
 
     struct strand {
@@ -134,10 +169,14 @@ struct run_loop {
         void operator()(time_point<clock_type> at, observer<OON...> out) const {
             guard_type guard(loop.get().lock);
             lifetime.insert(out.lifetime);
-            loop.get().deferred.push(item_type{at, out});
-            info(to_string(reinterpret_cast<ptrdiff_t>(addressof(loop.get()))) + " - run_loop: defer_at notify_all");
+            loop.get().deferred.push(item_type{at, move(out)});
+            RX_TRACE(addressof(loop.get()), "run_loop: defer_at notify_all");
             loop.get().wake.notify_all();
         }
+
+        shared_ptr<detail::stop_sweep> sweep() const {
+            return loop.get().sweep;
+        }
     };
 
     auto make() const {
@@ -0,0 +1,354 @@
+#pragma once
+
+namespace rx {
+
+namespace detail {
+
+///
+/// \brief the workers and timer shared by the strands of a thread_pool.
+/// Each worker has a deque of strands that are ready to run. A worker
+/// takes from the back of its own deque and steals from the front of the
+/// others. A strand is in at most one deque at a time, so the items of a
+/// strand run in order on one worker at a time.
+/// Items that are not ready yet wait in the strand. The strand arms a
+/// run_loop timer thread to make it ready at the time of its first item.
+/// The deques are locked rather than lock-free (Chase-Lev) because threads
+/// outside the pool also push to them and an entry is a whole strand, so
+/// the lock is taken once per batch of items. A thief reads the size of a
+/// deque before it takes the lock, so the empty deques are skipped.
+///
+template<class Clock, class Error>
+struct thread_pool_state : public enable_shared_from_this<thread_pool_state<Clock, Error>>
+{
+    using clock_type = decay_t<Clock>;
+    using error_type = decay_t<Error>;
+    using timer_type = run_loop<clock_type, error_type>;
+    using observer_type = observer_interface<re_defer_at_t<clock_type>, error_type>;
+    using item_type = observe_at<clock_type, observer_type>;
+    using queue_type = observe_at_queue<clock_type, observer_type>;
+
+    struct serial_queue : public enable_shared_from_this<serial_queue>
+    {
+        serial_queue(shared_ptr<thread_pool_state> pool, subscription lifetime)
+            : pool(move(pool))
+            , lifetime(lifetime)
+            , scheduled(false)
+            , armed(time_point<clock_type>::max()) {
+        }
+        shared_ptr<thread_pool_state> pool;
+        subscription lifetime;
+        mutex lock;
+        queue_type deferred;
+        /// true while the strand is in a deque or running on a worker
+        bool scheduled;
+        /// the earliest time that the timer will make this ready
+        time_point<clock_type> armed;
+
+        void defer_at(time_point<clock_type> at, observer_type out) {
+            unique_lock<mutex> guard(lock);
+            deferred.push(item_type{at, move(out)});
+            dispatch(guard);
+        }
+
+        void expired(time_point<clock_type> at) {
+            unique_lock<mutex> guard(lock);
+            if (at == armed) {
+                armed = time_point<clock_type>::max();
+            }
+            dispatch(guard);
+        }
+
+        /// schedules the strand when the first item is ready or arms the timer for it
+        void dispatch(unique_lock<mutex>& guard) {
+            if (scheduled || deferred.empty()) {
+                return;
+            }
+            auto when = deferred.top().when;
+            if (when <= clock_type::now()) {
+                RX_TRACE(this, "thread_pool: schedule strand");
+                scheduled = true;
+                guard.unlock();
+                pool->submit(this->shared_from_this());
+            } else if (when < armed) {
+                RX_TRACE(this, "thread_pool: arm timer");
+                armed = when;
+                guard.unlock();
+                pool->arm(when, this->shared_from_this());
+            }
+        }
+
+        /// runs the items that are ready. called on a worker.
+        void run() {
+            // the scratch buffer is moved out while in use so that
+            // a nested run on this thread will use a different buffer
+            static thread_local vector<item_type> scratch;
+            auto batch = move(scratch);
+
+            unique_lock<mutex> guard(lock);
+            auto now = clock_type::now();
+            while (!deferred.empty() && deferred.top().when <= now) {
+                batch.push_back(deferred.take());
+            }
+            guard.unlock();
+
+            size_t kept = 0;
+            for (auto& next : batch) {
+                if (!lifetime.is_stopped() && call(next)) {
+                    if (addressof(batch[kept]) != addressof(next)) {
+                        batch[kept] = move(next);
+                    }
+                    ++kept;
+                } else {
+                    // release the observer now instead of with the batch
+                    item_type done(move(next));
+                }
+            }
+            batch.erase(batch.begin() + kept, batch.end());
+
+            guard.lock();
+            for (auto& next : batch) {
+                deferred.push(move(next));
+            }
+            batch.clear();
+            scheduled = false;
+            dispatch(guard);
+
+            scratch = move(batch);
+        }
+
+        /// \returns true when next re-deferred itself
+        bool call(item_type& next) const {
+            bool complete = true;
+            next.what.next([&](time_point<clock_type> at){
+                if (lifetime.is_stopped() || next.what.lifetime.is_stopped()) return;
+                next.when = at;
+                complete = false;
+            });
+            if (complete) {
+                next.what.complete();
+            }
+            return !complete;
+        }
+    };
+    using task_type = shared_ptr<serial_queue>;
+
+    struct worker
+    {
+        worker() : size(0) {}
+        mutex lock;
+        deque<task_type> tasks;
+        /// the size of tasks, read without the lock
+        atomic<size_t> size;
+    };
+
+    explicit thread_pool_state(size_t count)
+        : workers(max<size_t>(1, count))
+        , pending(0)
+        , sleepers(0)
+        , stopped(false)
+        , next(0)
+        , timer(subscription{})
+        , alarm{timer.lifetime, timer.loop} {
+        for (auto& w : workers) {
+            w = make_unique<worker>();
+        }
+    }
+
+    vector<unique_ptr<worker>> workers;
+    atomic<size_t> pending;
+    atomic<size_t> sleepers;
+    atomic<bool> stopped;
+    /// round-robin for strands that are scheduled from threads outside the pool
+    atomic<size_t> next;
+    mutex lock;
+    condition_variable wake;
+    timer_type timer;
+    typename timer_type::strand alarm;
+
+    void start() {
+        auto self = this->shared_from_this();
+        for (size_t w = 0; w < workers.size(); ++w) {
+            std::thread([self, w](){
+                RX_TRACE(self.get(), "thread_pool: worker enter", w);
+                self->work(w);
+                RX_TRACE(self.get(), "thread_pool: worker exit", w);
+            }).detach();
+        }
+        std::thread([t = timer](){
+            t.run();
+        }).detach();
+    }
+
+    void stop() {
+        RX_TRACE(this, "thread_pool: stop");
+        stopped = true;
+        {
+            unique_lock<mutex> guard(lock);
+            wake.notify_all();
+        }
+        timer.lifetime.stop();
+        // the strands in the deques hold this state
+        for (auto& w : workers) {
+            deque<task_type> tasks;
+            {
+                unique_lock<mutex> guard(w->lock);
+                swap(tasks, w->tasks);
+                w->size.store(0, memory_order_relaxed);
+            }
+        }
+    }
+
+    /// the pool and worker index of the worker running on this thread
+    static thread_pool_state*& current_pool() {
+        static thread_local thread_pool_state* pool = nullptr;
+        return pool;
+    }
+    static size_t& current_worker() {
+        static thread_local size_t w = 0;
+        return w;
+    }
+
+    void submit(task_type task) {
+        auto w = current_pool() == this ? current_worker() : next++ % workers.size();
+        {
+            unique_lock<mutex> guard(workers[w]->lock);
+            workers[w]->tasks.push_back(move(task));
+            workers[w]->size.store(workers[w]->tasks.size(), memory_order_relaxed);
+        }
+        ++pending;
+        if (sleepers > 0) {
+            unique_lock<mutex> guard(lock);
+            wake.notify_one();
+        }
+    }
+
+    void arm(time_point<clock_type> at, const task_type& task) {
+        weak_ptr<serial_queue> weak = task;
+        alarm(at, make_observer(subscription{}, [weak, at](auto&){
+            if (auto q = weak.lock()) {
+                q->expired(at);
+            }
+        }));
+    }
+
+    task_type take(size_t w) {
+        task_type task;
+        {
+            auto& own = *workers[w];
+            unique_lock<mutex> guard(own.lock);
+            if (!own.tasks.empty()) {
+                task = move(own.tasks.back());
+                own.tasks.pop_back();
+                own.size.store(own.tasks.size(), memory_order_relaxed);
+            }
+        }
+        for (size_t i = 1; !task && i < workers.size(); ++i) {
+            auto& other = *workers[(w + i) % workers.size()];
+            if (other.size.load(memory_order_relaxed) == 0) {
+                continue;
+            }
+            unique_lock<mutex> guard(other.lock);
+            if (!other.tasks.empty()) {
+                task = move(other.tasks.front());
+                other.tasks.pop_front();
+                other.size.store(other.tasks.size(), memory_order_relaxed);
+            }
+        }
+        if (task) {
+            --pending;
+        }
+        return task;
+    }
+
+    void work(size_t w) {
+        current_pool() = this;
+        current_worker() = w;
+        while (!stopped) {
+            if (auto task = take(w)) {
+                task->run();
+                continue;
+            }
+            unique_lock<mutex> guard(lock);
+            ++sleepers;
+            wake.wait(guard, [&](){
+                return pending > 0 || stopped;
+            });
+            --sleepers;
+        }
+        current_pool() = nullptr;
+    }
+};
+
+}
+
+///
+/// \brief a fixed set of worker threads shared by many strands.
+/// the workers stop when the thread_pool is destroyed.
+///
+template<class Clock = steady_clock, class Error = exception_ptr>
+struct thread_pool
+{
+    using state_type = detail::thread_pool_state<Clock, Error>;
+
+    explicit thread_pool(size_t workers = std::thread::hardware_concurrency())
+        : state(make_shared<state_type>(workers)) {
+        state->start();
+    }
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool() {
+        state->stop();
+    }
+
+    shared_ptr<state_type> state;
+};
+
+template<class Clock, class Error>
+struct thread_pool_strand {
+    using serial_queue = typename detail::thread_pool_state<Clock, Error>::serial_queue;
+
+    /// keeps the workers running while the strand exists
+    shared_ptr<thread_pool<Clock, Error>> pool;
+    shared_ptr<serial_queue> queue;
+
+    template<class... ON>
+    void operator()(time_point_t<Clock> at, observer<ON...> out) const {
+        queue->lifetime.insert(out.lifetime);
+        queue->defer_at(at, move(out));
+    }
+};
+
+///
+/// \brief makes strands that run on a thread_pool.
+/// the default constructor uses a pool with a worker per core that is
+/// shared by the whole process.
+///
+template<class Clock = steady_clock, class Error = exception_ptr>
+struct make_thread_pool {
+    using pool_type = thread_pool<Clock, Error>;
+
+    make_thread_pool()
+        : pool(shared()) {
+    }
+    explicit make_thread_pool(size_t workers)
+        : pool(make_shared<pool_type>(workers)) {
+    }
+    explicit make_thread_pool(shared_ptr<pool_type> p)
+        : pool(move(p)) {
+    }
+
+    shared_ptr<pool_type> pool;
+
+    static shared_ptr<pool_type> shared() {
+        static auto pool = make_shared<pool_type>();
+        return pool;
+    }
+
+    auto operator()(subscription lifetime) const {
+        RX_TRACE(pool.get(), "thread_pool: create strand");
+        auto queue = make_shared<typename thread_pool_strand<Clock, Error>::serial_queue>(pool->state, lifetime);
+        return make_strand<Clock>(lifetime, thread_pool_strand<Clock, Error>{pool, queue}, detail::now<Clock>{});
+    }
+};
+
+}
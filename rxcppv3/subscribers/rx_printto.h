@@ -3,11 +3,11 @@
 namespace rx {
 
 const auto printto = [](auto& output){
-    info("new printto");
+    RX_TRACE("new printto");
     return make_subscriber([&](auto ctx) {
-        ::info("printto bound to context lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(ctx.lifetime.store.get())));
+        RX_TRACE(ctx.lifetime.store.get(), "printto bound to context lifetime");
         auto values = make_state<int>(ctx.lifetime, 0);
-        ::info("printto observer lifetime - " + to_string(reinterpret_cast<ptrdiff_t>(ctx.lifetime.store.get())));
+        RX_TRACE(ctx.lifetime.store.get(), "printto observer lifetime");
         auto start = ctx.now();
         return make_observer(
             ctx.lifetime,
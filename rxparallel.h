@@ -0,0 +1,48 @@
+#pragma once
+
+//
+// check that the parallel subject delivers every value and the
+// completion to every observer, when the input completes right
+// after the last value.
+//
+extern"C" void EMSCRIPTEN_KEEPALIVE rxparallelcomplete(int shards, int observers, int count)
+{
+    subjects::parallel<int, observe_on_one_worker> p(shards, observe_on_new_thread());
+
+    mutex lock;
+    condition_variable wake;
+    vector<long> received(observers, 0);
+    int completed = 0;
+
+    for (int o = 0; o < observers; ++o) {
+        p.get_observable().subscribe(
+            [&, o](int){
+                unique_lock<mutex> guard(lock);
+                ++received[o];
+            },
+            [&](){
+                unique_lock<mutex> guard(lock);
+                ++completed;
+                wake.notify_all();
+            });
+    }
+
+    auto in = p.get_subscriber();
+    for (int i = 0; i < count; ++i) {
+        in.on_next(i);
+    }
+    in.on_completed();
+
+    unique_lock<mutex> guard(lock);
+    wake.wait_for(guard, chrono::seconds(10), [&](){return completed == observers;});
+
+    long total = 0;
+    bool every = true;
+    for (auto r : received) {
+        total += r;
+        every = every && r == count;
+    }
+    cout << total << " of " << (long)observers * count << " values, "
+         << completed << " of " << observers << " completed"
+         << (every && completed == observers ? "" : " - FAILED") << endl;
+}
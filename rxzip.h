@@ -0,0 +1,44 @@
+#pragma once
+
+//
+// zip four sources of count ints that arrive at skewed rates.
+// each round the sources emit 1, 2, 3 and 4 values, so the faster
+// sources queue values in zip until the slowest catches up.
+//
+extern"C" void EMSCRIPTEN_KEEPALIVE rxzipskewed(int count, int capacity)
+{
+    using namespace std::chrono;
+
+    auto start = steady_clock::now();
+
+    subject<int> sources[4];
+    long long sum = 0;
+    long emitted = 0;
+
+    auto zipped = capacity > 0 ?
+        sources[0].get_observable().zip_bounded(capacity, sources[1].get_observable(), sources[2].get_observable(), sources[3].get_observable()).as_dynamic() :
+        sources[0].get_observable().zip(sources[1].get_observable(), sources[2].get_observable(), sources[3].get_observable()).as_dynamic();
+
+    zipped.subscribe(
+        [&](tuple<int, int, int, int> v){
+            sum += get<0>(v) + get<1>(v) + get<2>(v) + get<3>(v);
+            ++emitted;
+        },
+        [](exception_ptr ep){cout << what(ep) << endl;});
+
+    int next[4] = {0, 0, 0, 0};
+    for (bool more = true; more;) {
+        more = false;
+        for (int s = 0; s < 4; ++s) {
+            for (int r = 0; r <= s && next[s] < count; ++r) {
+                sources[s].get_subscriber().on_next(next[s]++);
+            }
+            more = more || next[s] < count;
+        }
+    }
+    for (auto& s : sources) {
+        s.get_subscriber().on_completed();
+    }
+
+    cout << emitted << " zipped, sum " << sum << ", " << duration_cast<milliseconds>(steady_clock::now() - start).count() << "ms" << endl;
+}